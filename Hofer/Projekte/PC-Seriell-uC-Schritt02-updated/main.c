@@ -6,6 +6,9 @@
  *    - Wenn ein Carriage Return (CR, '\r') empfangen wird, wird der komplette String
  *      als Nachricht in eine Message Queue gelegt.
  * 2. Der Main-Thread nimmt Nachrichten aus der Message Queue entgegen und wertet sie aus.
+ *
+ * Aufruf:     ./uC /dev/ttyACM0   (ohne Argument wird von stdin gelesen)
+ * Übersetzen: gcc -O2 -Wall -o uC main.c ../PC-Seriell-uC-Schritt03/uC/serialport.c -lpthread
  */
 
 #include <stdio.h>
@@ -15,66 +18,62 @@
 #include <stdlib.h>
 
 #define MAX_MSG_LEN 128
-#define QUEUE_SIZE 10
+#define CMD_RING_TEXT_LEN MAX_MSG_LEN
 
-char messageQueue[QUEUE_SIZE][MAX_MSG_LEN];
-int queueStart = 0;
-int queueEnd = 0;
+// Lock-freie SPSC-Queue aus Schritt03 (nur Header)
+#include "../PC-Seriell-uC-Schritt03/uC/cmdring.h"
+#include "../PC-Seriell-uC-Schritt03/uC/serialport.h"
 
-pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t queueCond = PTHREAD_COND_INITIALIZER;
+CommandRing messageQueue;
 
-// Hilfsfunktion: Nachricht in Queue legen
-void enqueueMessage(const char *msg) {
-    pthread_mutex_lock(&queueMutex);
-    strncpy(messageQueue[queueEnd], msg, MAX_MSG_LEN);
-    queueEnd = (queueEnd + 1) % QUEUE_SIZE;
-    pthread_cond_signal(&queueCond);
-    pthread_mutex_unlock(&queueMutex);
+// Hilfsfunktion: Nachricht in Queue legen (bei voller Queue verwerfen und zählen)
+void enqueueMessage(const char *msg, size_t len) {
+    if (!cmdRingPush(&messageQueue, msg, len)) {
+        fprintf(stderr, "Queue voll, Nachricht verworfen (%u gesamt)\n", cmdRingDrops(&messageQueue));
+    }
 }
 
-// Hilfsfunktion: Nachricht aus Queue lesen
-void dequeueMessage(char *buffer) {
-    pthread_mutex_lock(&queueMutex);
-    while (queueStart == queueEnd) {
-        pthread_cond_wait(&queueCond, &queueMutex);
-    }
-    strncpy(buffer, messageQueue[queueStart], MAX_MSG_LEN);
-    queueStart = (queueStart + 1) % QUEUE_SIZE;
-    pthread_mutex_unlock(&queueMutex);
+// Wird für jede Nachricht direkt im Ring aufgerufen (keine Kopie)
+void handleMessage(const Command *cmd, void *ctx) {
+    (void)ctx;
+    printf("Empfangenes Kommando: %s\n", cmd->text);
+    // Hier weitere Auswertung des Kommandos
+}
+
+// Empfangene Zeile (Zeiger in den Empfangspuffer) in die Queue legen
+void onLine(const char *line, size_t len, void *ctx) {
+    (void)ctx;
+    enqueueMessage(line, len);
 }
 
-// Thread für seriellen Empfang
+// Thread für seriellen Empfang: poll() wartet auf Daten, read() holt alles auf einmal
 void* serialReceiveThread(void* arg) {
-    char buffer[MAX_MSG_LEN];
-    int pos = 0;
-    int ch;
-    
-    while (1) {
-        ch = getchar(); // Beispiel: hier sollte UART-Leseoperation erfolgen
-        if (ch == '\r') {
-            buffer[pos] = '\0';
-            enqueueMessage(buffer);
-            pos = 0;
-        } else if (ch >= 32 && ch <= 126) {
-            if (pos < MAX_MSG_LEN - 1) {
-                buffer[pos++] = (char)ch;
-            }
-        }
-        usleep(1000);
+    static SerialReader reader;
+    serialReaderInit(&reader, *(int*)arg, NULL, onLine, NULL);
+
+    while (serialReaderPoll(&reader, -1) >= 0) {
+        // kein usleep() mehr: der Durchsatz ist nur noch durch die Baudrate begrenzt
     }
     return NULL;
 }
 
-int main() {
+int main(int argc, char **argv) {
     pthread_t recvThread;
-    pthread_create(&recvThread, NULL, serialReceiveThread, NULL);
+    int fd = STDIN_FILENO; // ohne Argument: Eingabe über das Terminal
+
+    if (argc > 1) {
+        fd = serialOpen(argv[1], 115200);
+        if (fd < 0) {
+            return 1;
+        }
+    }
+
+    cmdRingInit(&messageQueue);
+    pthread_create(&recvThread, NULL, serialReceiveThread, &fd);
 
-    char msg[MAX_MSG_LEN];
     while (1) {
-        dequeueMessage(msg);
-        printf("Empfangenes Kommando: %s\n", msg);
-        // Hier weitere Auswertung des Kommandos
+        cmdRingWait(&messageQueue); // schläft nur, wenn die Queue leer ist
+        cmdRingPopBatch(&messageQueue, handleMessage, NULL, CMD_RING_SIZE);
     }
 
     pthread_join(recvThread, NULL);
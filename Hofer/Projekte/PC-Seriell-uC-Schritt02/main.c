@@ -9,7 +9,11 @@
  *    - Unterstützte Kommandos:
  *        "LED ROT" / "LED rot" -> LED rot einschalten
  *        "OFF" -> Alle LEDs ausschalten
- *    - Leicht erweiterbar für zusätzliche Befehle
+ *    - Leicht erweiterbar für zusätzliche Befehle (COMMAND_LIST)
+ *
+ * Aufruf:     ./uC /dev/ttyACM0   (ohne Argument wird von stdin gelesen)
+ * Übersetzen: gcc -O2 -Wall -o uC main.c ../PC-Seriell-uC-Schritt03/uC/cmdtable.c \
+ *                 ../PC-Seriell-uC-Schritt03/uC/serialport.c -lpthread
  */
 
 #include <stdio.h>
@@ -17,94 +21,97 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <stdlib.h>
-#include <ctype.h>
 
 #define MAX_MSG_LEN 128
-#define QUEUE_SIZE 10
-
-char messageQueue[QUEUE_SIZE][MAX_MSG_LEN];
-int queueStart = 0;
-int queueEnd = 0;
-
-pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t queueCond = PTHREAD_COND_INITIALIZER;
-
-// Hilfsfunktion: Nachricht in Queue legen
-void enqueueMessage(const char *msg) {
-    pthread_mutex_lock(&queueMutex);
-    strncpy(messageQueue[queueEnd], msg, MAX_MSG_LEN);
-    queueEnd = (queueEnd + 1) % QUEUE_SIZE;
-    pthread_cond_signal(&queueCond);
-    pthread_mutex_unlock(&queueMutex);
-}
+#define CMD_RING_TEXT_LEN MAX_MSG_LEN
+
+// Lock-freie SPSC-Queue aus Schritt03 (nur Header)
+#include "../PC-Seriell-uC-Schritt03/uC/cmdring.h"
+#include "../PC-Seriell-uC-Schritt03/uC/serialport.h"
+#include "../PC-Seriell-uC-Schritt03/uC/cmdtable.h"
 
-// Hilfsfunktion: Nachricht aus Queue lesen
-void dequeueMessage(char *buffer) {
-    pthread_mutex_lock(&queueMutex);
-    while (queueStart == queueEnd) {
-        pthread_cond_wait(&queueCond, &queueMutex);
+CommandRing messageQueue;
+
+// Hilfsfunktion: Nachricht in Queue legen (bei voller Queue verwerfen und zählen)
+void enqueueMessage(const char *msg, size_t len) {
+    if (!cmdRingPush(&messageQueue, msg, len)) {
+        fprintf(stderr, "Queue voll, Nachricht verworfen (%u gesamt)\n", cmdRingDrops(&messageQueue));
     }
-    strncpy(buffer, messageQueue[queueStart], MAX_MSG_LEN);
-    queueStart = (queueStart + 1) % QUEUE_SIZE;
-    pthread_mutex_unlock(&queueMutex);
 }
 
-// Hilfsfunktion: String zu Uppercase konvertieren
-void strToUpper(char *str) {
-    for (int i = 0; str[i]; i++) {
-        str[i] = toupper((unsigned char)str[i]);
+// Kommando-Handler (Argumente sind bereits geparst)
+int cmdLed(const CmdArgs *args) {
+    if (!cmdArgIs(args, 0, "ROT")) {
+        return -1;
     }
+    printf("Kommando erkannt: LED ROT -> LED einschalten\n");
+    // TODO: Hier GPIO/LED einschalten
+    return 0;
 }
 
-// Funktion zur Befehlsauswertung
-void processCommand(const char *cmd) {
-    char upperCmd[MAX_MSG_LEN];
-    strncpy(upperCmd, cmd, MAX_MSG_LEN);
-    upperCmd[MAX_MSG_LEN-1] = '\0';
-    strToUpper(upperCmd);
-
-    if (strcmp(upperCmd, "LED ROT") == 0) {
-        printf("Kommando erkannt: LED ROT -> LED einschalten\n");
-        // TODO: Hier GPIO/LED einschalten
-    } else if (strcmp(upperCmd, "OFF") == 0) {
-        printf("Kommando erkannt: OFF -> Alle LEDs ausschalten\n");
-        // TODO: Hier GPIO/LED ausschalten
-    } else {
+int cmdOff(const CmdArgs *args) {
+    (void)args;
+    printf("Kommando erkannt: OFF -> Alle LEDs ausschalten\n");
+    // TODO: Hier GPIO/LED ausschalten
+    return 0;
+}
+
+// Kommandotabelle mit perfektem Hash (siehe Schritt03/uC/cmdtable.h)
+#define COMMAND_LIST(X)               \
+    X(LED, 'L', 'D', 1, 1, 0, cmdLed) \
+    X(OFF, 'O', 'F', 0, 0, 0, cmdOff)
+
+static const CmdEntry commandTable[CMD_TABLE_SIZE] = { COMMAND_LIST(CMD_ENTRY) };
+CMD_CHECK_UNIQUE(COMMAND_LIST)
+
+// Funktion zur Befehlsauswertung: ein Hash-Zugriff statt Vergleichskette, keine Kopie
+void processCommand(const char *cmd, size_t len) {
+    if (cmdDispatch(commandTable, cmd, len) != CMD_OK) {
         printf("Unbekanntes Kommando: %s\n", cmd);
     }
 }
 
-// Thread für seriellen Empfang
+// Wird für jede Nachricht direkt im Ring aufgerufen (keine Kopie)
+void handleMessage(const Command *cmd, void *ctx) {
+    (void)ctx;
+    printf("Empfangenes Kommando: %s\n", cmd->text);
+    processCommand(cmd->text, cmd->len);
+}
+
+// Empfangene Zeile (Zeiger in den Empfangspuffer) in die Queue legen
+void onLine(const char *line, size_t len, void *ctx) {
+    (void)ctx;
+    enqueueMessage(line, len);
+}
+
+// Thread für seriellen Empfang: poll() wartet auf Daten, read() holt alles auf einmal
 void* serialReceiveThread(void* arg) {
-    char buffer[MAX_MSG_LEN];
-    int pos = 0;
-    int ch;
-    
-    while (1) {
-        ch = getchar(); // UART-Leseoperation simuliert
-        if (ch == '\r') {
-            buffer[pos] = '\0';
-            enqueueMessage(buffer);
-            pos = 0;
-        } else if (ch >= 32 && ch <= 126) {
-            if (pos < MAX_MSG_LEN - 1) {
-                buffer[pos++] = (char)ch;
-            }
-        }
-        usleep(1000);
+    static SerialReader reader;
+    serialReaderInit(&reader, *(int*)arg, NULL, onLine, NULL);
+
+    while (serialReaderPoll(&reader, -1) >= 0) {
+        // kein usleep() mehr: der Durchsatz ist nur noch durch die Baudrate begrenzt
     }
     return NULL;
 }
 
-int main() {
+int main(int argc, char **argv) {
     pthread_t recvThread;
-    pthread_create(&recvThread, NULL, serialReceiveThread, NULL);
+    int fd = STDIN_FILENO; // ohne Argument: Eingabe über das Terminal
+
+    if (argc > 1) {
+        fd = serialOpen(argv[1], 115200);
+        if (fd < 0) {
+            return 1;
+        }
+    }
+
+    cmdRingInit(&messageQueue);
+    pthread_create(&recvThread, NULL, serialReceiveThread, &fd);
 
-    char msg[MAX_MSG_LEN];
     while (1) {
-        dequeueMessage(msg);
-        printf("Empfangenes Kommando: %s\n", msg);
-        processCommand(msg);
+        cmdRingWait(&messageQueue); // schläft nur, wenn die Queue leer ist
+        cmdRingPopBatch(&messageQueue, handleMessage, NULL, CMD_RING_SIZE);
     }
 
     pthread_join(recvThread, NULL);
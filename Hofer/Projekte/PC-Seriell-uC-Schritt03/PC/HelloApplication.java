@@ -4,6 +4,10 @@
  * JavaFX Programm, das serielle Befehle an den Microcontroller sendet.
  * In dieser einfachen Version werden nur Kommandos gesendet.
  * Empfangen und GUI-Aktualisierung kann leicht erweitert werden.
+ *
+ * Alle Daten werden als binäre Rahmen gesendet (Aufbau siehe uC/frame.h):
+ *   SYNC 0xA5 | TYPE | LEN | PAYLOAD | CRC-16 (CCITT-FALSE, High-Byte zuerst)
+ * Textkommandos -> Typ CMD, Drehzahl-Sollwert (Slider) -> Typ SETPOINT, Stopp -> Typ STOP.
  */
 
 import javafx.application.Application;
@@ -14,9 +18,17 @@ import javafx.scene.layout.VBox;
 import com.fazecast.jSerialComm.*;
 
 import java.io.OutputStream;
+import java.nio.charset.StandardCharsets;
 
 public class HelloApplication extends Application {
 
+    // --- Rahmenprotokoll (muss zu uC/frame.h passen) ---
+    private static final int FRAME_SYNC = 0xA5;
+    private static final int FRAME_MAX_PAYLOAD = 64;
+    private static final int FRAME_TYPE_CMD = 0x01;
+    private static final int FRAME_TYPE_SETPOINT = 0x02;
+    private static final int FRAME_TYPE_STOP = 0x03;
+
     private SerialPort serialPort;
     private OutputStream output;
 
@@ -25,11 +37,20 @@ public class HelloApplication extends Application {
         VBox root = new VBox(10);
         TextField inputField = new TextField();
         Button sendButton = new Button("Senden");
+        Slider speedSlider = new Slider(0, 10000, 0);
+        Label speedLabel = new Label("Sollwert: 0 U/min");
+        Button stopButton = new Button("STOPP");
         Label status = new Label("Nicht verbunden");
 
         sendButton.setOnAction(e -> sendCommand(inputField.getText()));
+        speedSlider.valueProperty().addListener((obs, oldVal, newVal) -> {
+            int rpm = newVal.intValue();
+            speedLabel.setText("Sollwert: " + rpm + " U/min");
+            sendSetpoint(rpm);
+        });
+        stopButton.setOnAction(e -> sendFrame(FRAME_TYPE_STOP, new byte[0]));
 
-        root.getChildren().addAll(inputField, sendButton, status);
+        root.getChildren().addAll(inputField, sendButton, speedSlider, speedLabel, stopButton, status);
         stage.setScene(new Scene(root, 300, 200));
         stage.setTitle("Serielle Steuerung");
         stage.show();
@@ -41,7 +62,7 @@ public class HelloApplication extends Application {
         SerialPort[] ports = SerialPort.getCommPorts();
         if (ports.length > 0) {
             serialPort = ports[0];
-            serialPort.setBaudRate(9600);
+            serialPort.setBaudRate(115200);
             if (serialPort.openPort()) {
                 output = serialPort.getOutputStream();
                 status.setText("Verbunden mit: " + serialPort.getSystemPortName());
@@ -54,9 +75,21 @@ public class HelloApplication extends Application {
     }
 
     private void sendCommand(String cmd) {
+        if (cmd != null && !cmd.isEmpty()) {
+            sendFrame(FRAME_TYPE_CMD, cmd.getBytes(StandardCharsets.US_ASCII));
+        }
+    }
+
+    private void sendSetpoint(int rpm) {
+        // uint16, Little Endian
+        byte[] payload = { (byte) rpm, (byte) (rpm >> 8) };
+        sendFrame(FRAME_TYPE_SETPOINT, payload);
+    }
+
+    private void sendFrame(int type, byte[] payload) {
         try {
-            if (output != null && cmd != null && !cmd.isEmpty()) {
-                output.write((cmd + "\n").getBytes());
+            if (output != null) {
+                output.write(encodeFrame(type, payload));
                 output.flush();
             }
         } catch (Exception ex) {
@@ -64,6 +97,33 @@ public class HelloApplication extends Application {
         }
     }
 
+    // Rahmen zusammenbauen: SYNC, TYPE, LEN, PAYLOAD, CRC_H, CRC_L
+    static byte[] encodeFrame(int type, byte[] payload) {
+        int len = Math.min(payload.length, FRAME_MAX_PAYLOAD);
+        byte[] frame = new byte[len + 5];
+        frame[0] = (byte) FRAME_SYNC;
+        frame[1] = (byte) type;
+        frame[2] = (byte) len;
+        System.arraycopy(payload, 0, frame, 3, len);
+        int crc = crc16(frame, 1, len + 2);
+        frame[3 + len] = (byte) (crc >> 8);
+        frame[4 + len] = (byte) crc;
+        return frame;
+    }
+
+    // CRC-16/CCITT-FALSE: Polynom 0x1021, Startwert 0xFFFF
+    static int crc16(byte[] data, int offset, int length) {
+        int crc = 0xFFFF;
+        for (int i = offset; i < offset + length; i++) {
+            crc ^= (data[i] & 0xFF) << 8;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = ((crc & 0x8000) != 0) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+                crc &= 0xFFFF;
+            }
+        }
+        return crc;
+    }
+
     public static void main(String[] args) {
         launch();
     }
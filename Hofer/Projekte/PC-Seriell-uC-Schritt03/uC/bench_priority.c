@@ -0,0 +1,220 @@
+/*
+ * bench_priority.c - Latenz eines STOP bei voller Kommando-Queue
+ *
+ * Aufbau wie in main.c: Empfangs-Thread (serialport.c über ein pty-Paar), SPSC-Ring
+ * (cmdring.h), Auswertungs-Thread mit Hash-Tabelle (cmdtable.c). Jeder SPEED-Befehl
+ * braucht in der Auswertung SLOW_CMD_US (z.B. langsame Ausgabe oder Bus-Zugriff).
+ *
+ * Pro Durchlauf werden zuerst viele SPEED-Befehle geschickt, sodass die Queue voll ist,
+ * danach ein STOP. Gemessen wird die Zeit vom Schreiben des STOP bis zum Aufruf des
+ * Stopp-Handlers.
+ *
+ *  - ohne Vorrang: STOP steht in der Queue hinter allen SPEED-Befehlen
+ *  - mit Vorrang:  STOP wird im Empfangs-Thread erkannt und sofort ausgeführt,
+ *                  die alten SPEED-Befehle werden danach verworfen
+ *
+ * Übersetzen: gcc -O2 -Wall -o bench_priority bench_priority.c serialport.c cmdtable.c -lpthread
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cmdring.h"
+#include "cmdtable.h"
+#include "serialport.h"
+
+#define SLOW_CMD_US 1000
+#define TRIALS_QUEUED 20
+#define TRIALS_PRIORITY 100
+#define STOP_BOUND_US 1000 // geforderte Obergrenze für den Stopp
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static CommandRing queue;
+static _Atomic uint32_t stopBarrier;
+static _Atomic uint64_t stopSentNs; // vom Schreiber gesetzt
+static _Atomic uint64_t stopDoneNs; // vom Stopp-Handler gesetzt
+static atomic_int useLane;
+static atomic_int running;
+
+// --- Handler ---
+static int cmdSpeed(const CmdArgs* args) {
+    (void)args;
+    struct timespec work = { 0, SLOW_CMD_US * 1000 };
+    nanosleep(&work, NULL);
+    return 0;
+}
+
+static int cmdStop(const CmdArgs* args) {
+    (void)args;
+    atomic_store(&stopDoneNs, nowNs());
+    if (atomic_load(&useLane)) {
+        atomic_store(&stopBarrier, cmdRingHead(&queue)); // läuft im Empfangs-Thread (Producer)
+    }
+    return 0;
+}
+
+#define PRIORITY_LIST(X)                \
+    X(STOP, 'S', 'P', 0, 0, 0, cmdStop)
+
+#define COMMAND_LIST(X)                                \
+    X(SPEED, 'S', 'D', 1, 1, CMD_ARG_NUM(0), cmdSpeed) \
+    X(STOP,  'S', 'P', 0, 0, 0,              cmdStop)
+
+static const CmdEntry priorityTable[CMD_TABLE_SIZE] = { PRIORITY_LIST(CMD_ENTRY) };
+static const CmdEntry commandTable[CMD_TABLE_SIZE] = { COMMAND_LIST(CMD_ENTRY) };
+CMD_CHECK_UNIQUE(COMMAND_LIST)
+
+// --- Empfang ---
+static void onLine(const char* line, size_t len, void* ctx) {
+    (void)ctx;
+    if (atomic_load(&useLane)) {
+        CmdResult result = cmdDispatch(priorityTable, line, len);
+        if (result != CMD_UNKNOWN && result != CMD_EMPTY) {
+            return; // Vorrang: sofort erledigt
+        }
+    }
+    cmdRingPush(&queue, line, len);
+}
+
+static void* receiverThread(void* arg) {
+    static SerialReader reader;
+    serialReaderInit(&reader, *(int*)arg, NULL, onLine, NULL);
+    while (atomic_load(&running) && serialReaderPoll(&reader, 50) >= 0) {
+    }
+    return NULL;
+}
+
+// --- Auswertung ---
+static void onCommand(const Command* cmd, void* ctx) {
+    (void)ctx;
+    if ((int32_t)(cmd->seq - atomic_load(&stopBarrier)) < 0) {
+        return; // durch Stopp überholt
+    }
+    cmdDispatch(commandTable, cmd->text, cmd->len);
+}
+
+static void* commandThread(void* arg) {
+    (void)arg;
+    while (atomic_load(&running)) {
+        cmdRingWait(&queue);
+        cmdRingPopBatch(&queue, onCommand, NULL, CMD_RING_SIZE);
+    }
+    return NULL;
+}
+
+static int cmpU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Latenz in us, -1 = Stopp ist nie angekommen
+static double toUs(uint64_t ns) {
+    return ns == UINT64_MAX ? -1.0 : ns / 1e3;
+}
+
+static void sleepUs(long us) {
+    struct timespec ts = { us / 1000000, (us % 1000000) * 1000 };
+    nanosleep(&ts, NULL);
+}
+
+static void runBench(const char* name, int lane, int speedsPerTrial, int trials) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("pty");
+        exit(1);
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0 || serialConfigure(slave, 115200) != 0) {
+        perror("pty slave");
+        exit(1);
+    }
+
+    cmdRingInit(&queue);
+    atomic_store(&stopBarrier, 0);
+    atomic_store(&useLane, lane);
+    atomic_store(&running, 1);
+
+    pthread_t rx, cmd;
+    pthread_create(&rx, NULL, receiverThread, &slave);
+    pthread_create(&cmd, NULL, commandThread, NULL);
+
+    uint64_t* latency = calloc((size_t)trials, sizeof(uint64_t));
+    char burst[64 * 512];
+    int missed = 0;
+
+    for (int t = 0; t < trials; t++) {
+        // Queue füllen
+        int len = 0;
+        for (int i = 0; i < speedsPerTrial; i++) {
+            len += snprintf(burst + len, sizeof(burst) - (size_t)len, "SPEED %d\r", 1000 + i);
+        }
+        if (write(master, burst, (size_t)len) != len) {
+            perror("write");
+            exit(1);
+        }
+        sleepUs(2000); // Empfang hat die SPEED-Befehle eingereiht, Auswertung arbeitet
+
+        atomic_store(&stopDoneNs, 0);
+        atomic_store(&stopSentNs, nowNs());
+        if (write(master, "STOP\r", 5) != 5) {
+            perror("write");
+            exit(1);
+        }
+
+        // auf den Stopp warten (ohne Vorrang kann er bei voller Queue auch verloren gehen)
+        uint64_t deadline = nowNs() + 500000000ull;
+        while (atomic_load(&stopDoneNs) == 0 && nowNs() < deadline) {
+            sleepUs(100);
+        }
+        if (atomic_load(&stopDoneNs) == 0) {
+            missed++;
+            latency[t] = UINT64_MAX;
+        } else {
+            latency[t] = atomic_load(&stopDoneNs) - atomic_load(&stopSentNs);
+        }
+        // Queue leer laufen lassen
+        while (atomic_load(&queue.tail) != atomic_load(&queue.head)) {
+            sleepUs(500);
+        }
+        sleepUs(2000);
+    }
+
+    atomic_store(&running, 0);
+    cmdRingPush(&queue, "", 0); // Auswertungs-Thread aufwecken
+    pthread_join(rx, NULL);
+    pthread_join(cmd, NULL);
+
+    qsort(latency, (size_t)trials, sizeof(uint64_t), cmpU64);
+    uint64_t max = latency[trials - 1];
+    printf("%-34s p50 %9.1f us  p99 %9.1f us  max %9.1f us  verloren %d  Grenze %d us: %s\n",
+           name, toUs(latency[trials / 2]), toUs(latency[trials * 99 / 100]), toUs(max), missed, STOP_BOUND_US,
+           max <= STOP_BOUND_US * 1000ull ? "eingehalten" : "VERLETZT");
+
+    free(latency);
+    close(slave);
+    close(master);
+}
+
+int main() {
+    printf("STOP hinter %d SPEED-Befehlen zu je %d us (Queue %d Plätze):\n",
+           CMD_RING_SIZE - 1, SLOW_CMD_US, CMD_RING_SIZE);
+    runBench("  ohne Vorrang", 0, CMD_RING_SIZE - 1, TRIALS_QUEUED);
+    runBench("  mit Vorrang", 1, CMD_RING_SIZE - 1, TRIALS_PRIORITY);
+    printf("STOP nach %d SPEED-Befehlen (Queue läuft über):\n", 4 * CMD_RING_SIZE);
+    runBench("  ohne Vorrang", 0, 4 * CMD_RING_SIZE, TRIALS_QUEUED);
+    runBench("  mit Vorrang", 1, 4 * CMD_RING_SIZE, TRIALS_PRIORITY);
+    return 0;
+}
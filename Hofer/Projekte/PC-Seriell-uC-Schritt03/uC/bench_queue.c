@@ -0,0 +1,202 @@
+/*
+ * bench_queue.c - Vergleich alte messageQueue (Mutex + Condition Variable) gegen cmdring.h
+ *
+ * Ein Producer-Thread schickt Kommandos der Form "SPEED 1200 #<Zeitstempel ns>",
+ * ein Consumer-Thread wertet sie aus und misst die Zeit vom Einfügen bis zur Auswertung.
+ *
+ *  - Burst:    Producer schreibt so schnell er kann -> Kommandos/s, verlorene Kommandos
+ *  - Getaktet: ein Kommando alle PACED_INTERVAL_NS -> Latenz (p50, p99, max)
+ *    Dabei schläft der Consumer zwischen den Kommandos, gemessen wird also inkl. Aufwecken.
+ *
+ * Die alte Queue überschreibt bei Überlauf ungelesene Einträge; "verloren" sind dort alle
+ * Kommandos, die nie beim Consumer angekommen sind. Beim Ring wartet der Producer, wenn
+ * die Queue voll ist, es geht also nichts verloren.
+ *
+ * Übersetzen: gcc -O2 -Wall -o bench_queue bench_queue.c -lpthread
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <sched.h>
+
+#define CMD_MAX_LEN 64
+#define CMD_RING_TEXT_LEN CMD_MAX_LEN
+
+#include "cmdring.h"
+
+#define BURST_COUNT 1000000
+#define PACED_COUNT 20000
+#define PACED_INTERVAL_NS 100000 // 10000 Kommandos/s, weit über dem, was 115200 Baud liefert
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// --- Alte Implementierung (wie bisher in main.c) ---
+#define QUEUE_SIZE 10
+
+char messageQueue[QUEUE_SIZE][CMD_MAX_LEN];
+int queueHead = 0;
+int queueTail = 0;
+pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t queueCond = PTHREAD_COND_INITIALIZER;
+
+void enqueueCommand(const char* cmd) {
+    pthread_mutex_lock(&queueMutex);
+    strncpy(messageQueue[queueTail], cmd, CMD_MAX_LEN-1);
+    messageQueue[queueTail][CMD_MAX_LEN-1] = '\0';
+    queueTail = (queueTail + 1) % QUEUE_SIZE;
+    pthread_cond_signal(&queueCond);
+    pthread_mutex_unlock(&queueMutex);
+}
+
+int dequeueCommand(char* buffer) {
+    pthread_mutex_lock(&queueMutex);
+    while (queueHead == queueTail) {
+        pthread_cond_wait(&queueCond, &queueMutex);
+    }
+    strncpy(buffer, messageQueue[queueHead], CMD_MAX_LEN);
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    pthread_mutex_unlock(&queueMutex);
+    return 1;
+}
+
+// --- Gemeinsame Messdaten ---
+typedef struct {
+    int useRing;
+    int count;
+    uint64_t intervalNs;     // 0 = Burst
+    uint32_t sent;
+    uint32_t delivered;
+    uint32_t rejected;       // Ring war voll (Push wiederholt)
+    uint64_t* latency;       // eine Latenz pro angekommenem Kommando
+    atomic_int consumerDone;
+} Bench;
+
+static CommandRing ring;
+
+// Zeitstempel aus dem Kommando holen, -1 für das Ende-Kommando
+static int64_t handleText(const char* text) {
+    if (strcmp(text, "END") == 0) {
+        return -1;
+    }
+    const char* p = strchr(text, '#');
+    return p ? (int64_t)strtoull(p + 1, NULL, 10) : 0;
+}
+
+static void onRingCommand(const Command* cmd, void* ctx) {
+    Bench* b = ctx;
+    int64_t stamp = handleText(cmd->text);
+    if (stamp < 0) {
+        atomic_store(&b->consumerDone, 1);
+    } else if (b->delivered < (uint32_t)b->count) {
+        b->latency[b->delivered++] = nowNs() - (uint64_t)stamp;
+    }
+}
+
+static void* consumerThread(void* arg) {
+    Bench* b = arg;
+    char buffer[CMD_MAX_LEN];
+
+    while (!atomic_load(&b->consumerDone)) {
+        if (b->useRing) {
+            cmdRingWait(&ring);
+            cmdRingPopBatch(&ring, onRingCommand, b, CMD_RING_SIZE);
+        } else if (dequeueCommand(buffer)) {
+            int64_t stamp = handleText(buffer);
+            if (stamp < 0) {
+                atomic_store(&b->consumerDone, 1);
+            } else if (b->delivered < (uint32_t)b->count) {
+                b->latency[b->delivered++] = nowNs() - (uint64_t)stamp;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void push(Bench* b, const char* text) {
+    if (b->useRing) {
+        // Ring voll: Drop wird gezählt, der Producer gibt die CPU ab und versucht es erneut
+        // (Gegendruck). Die alte Queue merkt nicht, dass sie voll ist, und überschreibt.
+        while (!cmdRingPush(&ring, text, strlen(text))) {
+            b->rejected++;
+            sched_yield();
+        }
+    } else {
+        enqueueCommand(text);
+    }
+}
+
+static int cmpU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void runBench(const char* name, int useRing, int count, uint64_t intervalNs) {
+    Bench b = { .useRing = useRing, .count = count, .intervalNs = intervalNs };
+    b.latency = malloc(sizeof(uint64_t) * (size_t)count);
+    atomic_init(&b.consumerDone, 0);
+
+    queueHead = queueTail = 0;
+    cmdRingInit(&ring);
+
+    pthread_t consumer;
+    pthread_create(&consumer, NULL, consumerThread, &b);
+
+    char text[CMD_MAX_LEN];
+    uint64_t start = nowNs();
+    uint64_t next = start;
+    for (int i = 0; i < count; i++) {
+        if (intervalNs) {
+            // absolut schlafen, damit sich der Takt nicht aufsummiert und der Consumer
+            // auch auf einem Rechner mit nur einem Kern drankommt
+            next += intervalNs;
+            struct timespec ts = { (time_t)(next / 1000000000ull), (long)(next % 1000000000ull) };
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        }
+        snprintf(text, sizeof(text), "SPEED %d #%llu", 1000 + (i & 1023), (unsigned long long)nowNs());
+        push(&b, text);
+        b.sent++;
+    }
+
+    // Ende-Kommando so lange schicken, bis es ankommt (die alte Queue kann es überschreiben)
+    while (!atomic_load(&b.consumerDone)) {
+        push(&b, "END");
+        struct timespec pause = { 0, 100000 };
+        nanosleep(&pause, NULL);
+    }
+    uint64_t elapsed = nowNs() - start;
+    pthread_join(consumer, NULL);
+
+    qsort(b.latency, b.delivered, sizeof(uint64_t), cmpU64);
+    uint64_t p50 = b.delivered ? b.latency[b.delivered / 2] : 0;
+    uint64_t p99 = b.delivered ? b.latency[(uint64_t)b.delivered * 99 / 100] : 0;
+    uint64_t max = b.delivered ? b.latency[b.delivered - 1] : 0;
+
+    printf("%-22s %9u gesendet %9u angekommen %9u verloren %10.0f Kmd/s  p50 %7.1f us  p99 %8.1f us  max %9.1f us",
+           name, b.sent, b.delivered, b.sent - b.delivered,
+           b.delivered / (elapsed / 1e9), p50 / 1e3, p99 / 1e3, max / 1e3);
+    if (useRing) {
+        printf("  (voll %u, high water %u/%d)", b.rejected, cmdRingHighWater(&ring), CMD_RING_SIZE);
+    }
+    printf("\n");
+    free(b.latency);
+}
+
+int main() {
+    printf("Burst (%d Kommandos):\n", BURST_COUNT);
+    runBench("  Mutex-Queue", 0, BURST_COUNT, 0);
+    runBench("  SPSC-Ring", 1, BURST_COUNT, 0);
+
+    printf("Getaktet (%d Kommandos, alle %d us):\n", PACED_COUNT, PACED_INTERVAL_NS / 1000);
+    runBench("  Mutex-Queue", 0, PACED_COUNT, PACED_INTERVAL_NS);
+    runBench("  SPSC-Ring", 1, PACED_COUNT, PACED_INTERVAL_NS);
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * bench_serial.c - Empfangsdurchsatz und Latenz über ein Linux-pty-Paar
+ *
+ * Der Master des pty spielt den PC, die Slave-Seite wird wie ein echtes tty mit
+ * serialConfigure() auf 115200 Baud raw gestellt und von serialReaderPoll() gelesen.
+ * Jedes Kommando trägt seinen Sendezeitpunkt: "SPEED 1200 #<ns>\r".
+ *
+ *  1. Zeilenrate:  Kommandos genau so schnell, wie sie bei 115200 Baud (10 Bit/Byte) ankämen
+ *                  -> Durchsatz muss die Zeilenrate erreichen, Latenz pro Kommando
+ *  2. Maximal:     so schnell wie möglich (ein pty hat keine Baudrate) -> Reserve des Empfängers
+ *  3. Alt:         bisheriger Empfang, ein Byte pro read() und usleep(1000) danach
+ *
+ * Übersetzen: gcc -O2 -Wall -o bench_serial bench_serial.c serialport.c -lpthread
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "serialport.h"
+
+#define BAUD 115200
+#define LINE_RATE_SECONDS 2
+#define MAX_COMMANDS 200000
+#define OLD_COMMANDS 40
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void sleepUntil(uint64_t t) {
+    struct timespec ts = { (time_t)(t / 1000000000ull), (long)(t % 1000000000ull) };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+// --- Messdaten des Empfängers ---
+typedef struct {
+    int fd;
+    uint32_t lines;
+    uint64_t bytes;
+    uint64_t firstNs, lastNs;
+    uint64_t* latency;
+    uint32_t maxLatency;
+    atomic_int done;
+} RxBench;
+
+static void onLine(const char* line, size_t len, void* ctx) {
+    RxBench* b = ctx;
+    uint64_t now = nowNs();
+
+    b->bytes += len + 1; // inkl. CR
+    if (len == 3 && memcmp(line, "END", 3) == 0) {
+        atomic_store(&b->done, 1);
+        return;
+    }
+    // Zeile ist nicht nullterminiert -> Zeitstempel nur bis len lesen
+    const char* p = memchr(line, '#', len);
+    if (p && b->lines < b->maxLatency) {
+        uint64_t stamp = 0;
+        for (p++; p < line + len && *p >= '0' && *p <= '9'; p++) {
+            stamp = stamp * 10 + (uint64_t)(*p - '0');
+        }
+        b->latency[b->lines] = now - stamp;
+    }
+    if (b->lines == 0) {
+        b->firstNs = now;
+    }
+    b->lastNs = now;
+    b->lines++;
+}
+
+// Neuer Empfang: poll() + blockweises read()
+static void* newReaderThread(void* arg) {
+    RxBench* b = arg;
+    static SerialReader reader;
+    serialReaderInit(&reader, b->fd, NULL, onLine, b);
+    while (!atomic_load(&b->done) && serialReaderPoll(&reader, 100) >= 0) {
+    }
+    return NULL;
+}
+
+// Alter Empfang wie in Schritt02: ein Zeichen, dann usleep(1000)
+static void* oldReaderThread(void* arg) {
+    RxBench* b = arg;
+    char buffer[128];
+    int pos = 0;
+    char ch;
+
+    while (!atomic_load(&b->done)) {
+        if (read(b->fd, &ch, 1) != 1) {
+            break;
+        }
+        if (ch == '\r') {
+            onLine(buffer, (size_t)pos, b);
+            pos = 0;
+        } else if (ch >= 32 && ch <= 126 && pos < (int)sizeof(buffer) - 1) {
+            buffer[pos++] = ch;
+        }
+        usleep(1000);
+    }
+    return NULL;
+}
+
+static int cmpU64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// count Kommandos senden; paced = im Takt der Baudrate
+static void runBench(const char* name, void* (*reader)(void*), uint32_t count, int paced, double seconds) {
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("pty");
+        exit(1);
+    }
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    if (slave < 0 || serialConfigure(slave, BAUD) != 0) {
+        perror("pty slave");
+        exit(1);
+    }
+
+    RxBench b = { .fd = slave, .maxLatency = count };
+    b.latency = calloc(count, sizeof(uint64_t));
+    atomic_init(&b.done, 0);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, reader, &b);
+
+    char text[64];
+    uint32_t sent = 0;
+    uint64_t start = nowNs();
+    uint64_t next = start;
+    uint64_t stop = start + (uint64_t)(seconds * 1e9);
+
+    while (sent < count && (!paced || seconds == 0 || nowNs() < stop)) {
+        int len = snprintf(text, sizeof(text), "SPEED %u #%llu\r", 1000 + (sent & 1023),
+                           (unsigned long long)nowNs());
+        if (write(master, text, (size_t)len) != len) {
+            break;
+        }
+        sent++;
+        if (paced) {
+            next += (uint64_t)len * 10u * 1000000000ull / BAUD; // Dauer des Kommandos auf der Leitung
+            sleepUntil(next);
+        }
+    }
+    while (write(master, "END\r", 4) != 4) {
+    }
+    pthread_join(thread, NULL);
+
+    double rxSeconds = (b.lastNs - start) / 1e9;
+    uint32_t n = b.lines < count ? b.lines : count;
+    qsort(b.latency, n, sizeof(uint64_t), cmpU64);
+    printf("%-12s %7u Kmd  %9.0f Byte/s (Zeilenrate %u)  p50 %8.1f us  p99 %9.1f us  max %10.1f us\n",
+           name, b.lines, (b.bytes - 4) / rxSeconds, BAUD / 10,
+           n ? b.latency[n / 2] / 1e3 : 0, n ? b.latency[(uint64_t)n * 99 / 100] / 1e3 : 0,
+           n ? b.latency[n - 1] / 1e3 : 0);
+
+    free(b.latency);
+    close(slave);
+    close(master);
+}
+
+int main() {
+    runBench("Zeilenrate", newReaderThread, MAX_COMMANDS, 1, LINE_RATE_SECONDS);
+    runBench("Maximal", newReaderThread, MAX_COMMANDS, 0, 0);
+    runBench("Alt", oldReaderThread, OLD_COMMANDS, 1, 0);
+    return 0;
+}
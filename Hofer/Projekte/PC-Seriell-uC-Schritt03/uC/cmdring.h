@@ -0,0 +1,167 @@
+/*
+ * cmdring.h - Lock-freie Kommando-Queue (Single Producer / Single Consumer)
+ *
+ * Ersetzt die alte messageQueue mit Mutex + Condition Variable:
+ *  - genau ein Thread schreibt (Empfang), genau ein Thread liest (Auswertung)
+ *  - Größe ist eine Zweierpotenz -> Index über Maske statt Modulo
+ *  - head/tail laufen frei (uint32_t) und werden nur vom jeweiligen Besitzer geschrieben,
+ *    daher ist im Normalfall kein Lock nötig
+ *  - volle Queue: das NEUE Kommando wird verworfen und gezählt (drops),
+ *    ungelesene Einträge werden nie überschrieben
+ *  - zu lange Kommandos (>= CMD_RING_TEXT_LEN) werden ebenfalls verworfen und gezählt (tooLong),
+ *    nie abgeschnitten: ein gekürztes Kommando könnte etwas anderes bedeuten
+ *  - highWater merkt sich den höchsten Füllstand
+ *  - der Leser holt alle vorhandenen Kommandos in einem Durchgang (Batch) und gibt
+ *    die Plätze erst danach mit einem einzigen Schreibzugriff frei
+ *  - Mutex + Condition Variable werden nur benutzt, wenn die Queue wirklich leer ist
+ *    und der Leser schlafen geht
+ *
+ * Nur Header, damit auch die Schritt02-Programme die Queue einbinden können.
+ * CMD_RING_SIZE und CMD_RING_TEXT_LEN können vor dem #include überschrieben werden.
+ */
+
+#ifndef CMDRING_H
+#define CMDRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifndef CMD_RING_SIZE
+#define CMD_RING_SIZE 64 // Anzahl Einträge, Zweierpotenz
+#endif
+
+#ifndef CMD_RING_TEXT_LEN
+#define CMD_RING_TEXT_LEN 64 // max. Kommandolänge inkl. '\0'
+#endif
+
+_Static_assert((CMD_RING_SIZE & (CMD_RING_SIZE - 1)) == 0, "CMD_RING_SIZE muss eine Zweierpotenz sein");
+
+// --- Ein Eintrag: Länge + Text, nullterminiert ---
+typedef struct {
+    uint32_t seq; // laufende Nummer (Stand von head beim Einfügen)
+    uint32_t len;
+    char text[CMD_RING_TEXT_LEN];
+} Command;
+
+typedef void (*CommandHandler)(const Command* cmd, void* ctx);
+
+typedef struct {
+    // Schreiber und Leser auf eigenen Cache-Lines, damit sie sich nicht gegenseitig ausbremsen
+    _Alignas(64) _Atomic uint32_t head; // nächster Schreibplatz (nur Producer)
+    _Atomic uint32_t highWater;         // höchster Füllstand (nur Producer schreibt)
+    _Atomic uint32_t drops;             // verworfene Kommandos (Queue voll)
+    _Atomic uint32_t tooLong;           // verworfene Kommandos (länger als CMD_RING_TEXT_LEN - 1)
+    _Alignas(64) _Atomic uint32_t tail; // nächster Leseplatz (nur Consumer)
+    _Atomic int waiting;                // Consumer schläft (oder ist kurz davor)
+    pthread_mutex_t lock;               // nur für das Schlafen bei leerer Queue
+    pthread_cond_t cond;
+    Command slots[CMD_RING_SIZE];
+} CommandRing;
+
+static inline void cmdRingInit(CommandRing* r) {
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->drops, 0);
+    atomic_init(&r->tooLong, 0);
+    atomic_init(&r->waiting, 0);
+    atomic_init(&r->highWater, 0);
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->cond, NULL);
+}
+
+// --- Producer: Kommando anhängen, Rückgabe 0 wenn die Queue voll oder das Kommando zu lang war ---
+static inline int cmdRingPush(CommandRing* r, const char* text, size_t len) {
+    if (len > CMD_RING_TEXT_LEN - 1) {
+        atomic_fetch_add_explicit(&r->tooLong, 1, memory_order_relaxed);
+        return 0;
+    }
+
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+
+    if (head - tail >= CMD_RING_SIZE) {
+        atomic_fetch_add_explicit(&r->drops, 1, memory_order_relaxed);
+        return 0;
+    }
+
+    Command* slot = &r->slots[head & (CMD_RING_SIZE - 1)];
+    memcpy(slot->text, text, len); // nur die echte Länge kopieren, nicht den ganzen Platz
+    slot->text[len] = '\0';
+    slot->len = (uint32_t)len;
+    slot->seq = head;
+
+    // seq_cst: Veröffentlichen von head und Lesen von waiting dürfen nicht vertauscht werden,
+    // sonst könnte ein gerade einschlafender Consumer das Kommando verpassen
+    atomic_store(&r->head, head + 1);
+
+    uint32_t fill = head + 1 - tail;
+    if (fill > atomic_load_explicit(&r->highWater, memory_order_relaxed)) {
+        atomic_store_explicit(&r->highWater, fill, memory_order_relaxed);
+    }
+
+    if (atomic_load(&r->waiting)) {
+        pthread_mutex_lock(&r->lock);
+        pthread_cond_signal(&r->cond);
+        pthread_mutex_unlock(&r->lock);
+    }
+    return 1;
+}
+
+// --- Consumer: bis zu max Kommandos direkt im Ring abarbeiten, Rückgabe = Anzahl ---
+static inline size_t cmdRingPopBatch(CommandRing* r, CommandHandler handler, void* ctx, size_t max) {
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    uint32_t n = head - tail;
+
+    if (n > max) {
+        n = (uint32_t)max;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        handler(&r->slots[(tail + i) & (CMD_RING_SIZE - 1)], ctx);
+    }
+    if (n > 0) {
+        // Plätze erst nach der Auswertung freigeben -> keine Kopie aus dem Ring nötig
+        atomic_store_explicit(&r->tail, tail + n, memory_order_release);
+    }
+    return n;
+}
+
+// --- Consumer: schlafen, bis mindestens ein Kommando da ist ---
+static inline void cmdRingWait(CommandRing* r) {
+    uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+    if (atomic_load_explicit(&r->head, memory_order_acquire) != tail) {
+        return; // schon etwas da, kein Lock nötig
+    }
+    pthread_mutex_lock(&r->lock);
+    atomic_store(&r->waiting, 1);
+    while (atomic_load(&r->head) == tail) {
+        pthread_cond_wait(&r->cond, &r->lock);
+    }
+    atomic_store(&r->waiting, 0);
+    pthread_mutex_unlock(&r->lock);
+}
+
+// --- Producer: Nummer, die das nächste Kommando bekommt ---
+// Alle Kommandos mit kleinerer seq sind bereits eingefügt (z.B. als Grenze für "verwerfen").
+static inline uint32_t cmdRingHead(CommandRing* r) {
+    return atomic_load_explicit(&r->head, memory_order_relaxed);
+}
+
+// --- Statistik ---
+static inline uint32_t cmdRingDrops(CommandRing* r) {
+    return atomic_load_explicit(&r->drops, memory_order_relaxed);
+}
+
+static inline uint32_t cmdRingTooLong(CommandRing* r) {
+    return atomic_load_explicit(&r->tooLong, memory_order_relaxed);
+}
+
+static inline uint32_t cmdRingHighWater(CommandRing* r) {
+    return atomic_load_explicit(&r->highWater, memory_order_relaxed);
+}
+
+#endif
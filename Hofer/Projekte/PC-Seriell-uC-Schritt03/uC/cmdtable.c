@@ -0,0 +1,130 @@
+/*
+ * cmdtable.c - Kommando-Auswertung über die Hash-Tabelle (siehe cmdtable.h)
+ */
+
+#include "cmdtable.h"
+
+#include <string.h>
+#include <strings.h>
+
+static int isSpace(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// --- Zahl mit optionaler Einheit parsen, Rückgabe 1 wenn gültig ---
+static int parseNumber(const char* s, size_t len, int32_t* out) {
+    size_t i = 0;
+    int negative = 0;
+    int64_t value = 0;
+
+    if (i < len && (s[i] == '-' || s[i] == '+')) {
+        negative = (s[i] == '-');
+        i++;
+    }
+    size_t digitsStart = i;
+    while (i < len && s[i] >= '0' && s[i] <= '9') {
+        value = value * 10 + (s[i] - '0');
+        if (value > INT32_MAX) {
+            return 0;
+        }
+        i++;
+    }
+    if (i == digitsStart) {
+        return 0; // keine Ziffer
+    }
+
+    // Einheit: Zeitangaben werden in ns umgerechnet
+    size_t unitLen = len - i;
+    if (unitLen == 2 && strncasecmp(&s[i], "NS", 2) == 0) {
+        // Basis
+    } else if (unitLen == 2 && strncasecmp(&s[i], "US", 2) == 0) {
+        value *= 1000;
+    } else if (unitLen == 2 && strncasecmp(&s[i], "MS", 2) == 0) {
+        value *= 1000000;
+    } else if (unitLen != 0) {
+        return 0; // unbekannte Einheit
+    }
+    if (value > INT32_MAX) {
+        return 0;
+    }
+
+    *out = (int32_t)(negative ? -value : value);
+    return 1;
+}
+
+CmdResult cmdDispatch(const CmdEntry* table, const char* text, size_t len) {
+    size_t pos = 0;
+
+    // --- Schlüsselwort ---
+    while (pos < len && isSpace(text[pos])) {
+        pos++;
+    }
+    size_t keyStart = pos;
+    while (pos < len && !isSpace(text[pos])) {
+        pos++;
+    }
+    size_t keyLen = pos - keyStart;
+    if (keyLen == 0) {
+        return CMD_EMPTY;
+    }
+
+    const char* key = &text[keyStart];
+    const CmdEntry* entry = &table[CMD_HASH(keyLen, key[0], key[keyLen - 1])];
+    if (entry->name == NULL || entry->len != keyLen || strncasecmp(key, entry->name, keyLen) != 0) {
+        return CMD_UNKNOWN;
+    }
+
+    // --- Argumente direkt im Text aufteilen und parsen ---
+    CmdArgs args;
+    args.count = 0;
+    args.numberMask = 0;
+    while (1) {
+        while (pos < len && isSpace(text[pos])) {
+            pos++;
+        }
+        if (pos >= len) {
+            break;
+        }
+        if (args.count >= CMD_MAX_ARGS) {
+            return CMD_BAD_ARGS;
+        }
+        size_t start = pos;
+        while (pos < len && !isSpace(text[pos])) {
+            pos++;
+        }
+        int i = args.count++;
+        args.word[i] = &text[start];
+        args.wordLen[i] = (uint8_t)((pos - start) > 255 ? 255 : (pos - start));
+        args.value[i] = 0;
+        if (parseNumber(&text[start], pos - start, &args.value[i])) {
+            args.numberMask |= (uint8_t)(1u << i);
+        }
+    }
+
+    if (args.count < entry->minArgs || args.count > entry->maxArgs) {
+        return CMD_BAD_ARGS;
+    }
+    // Nur geforderte Argumente prüfen, die auch angegeben wurden
+    uint8_t given = (uint8_t)((1u << args.count) - 1u);
+    if ((entry->numberMask & given & ~args.numberMask) != 0) {
+        return CMD_BAD_ARGS;
+    }
+
+    return entry->handler(&args) == 0 ? CMD_OK : CMD_REJECTED;
+}
+
+int cmdArgIs(const CmdArgs* args, int i, const char* word) {
+    size_t n = strlen(word);
+    return i < args->count && args->wordLen[i] == n && strncasecmp(args->word[i], word, n) == 0;
+}
+
+const char* cmdResultText(CmdResult result) {
+    switch (result) {
+    case CMD_OK:       return "ok";
+    case CMD_EMPTY:    return "leer";
+    case CMD_UNKNOWN:  return "unbekanntes Kommando";
+    case CMD_BAD_ARGS: return "falsche Argumente";
+    case CMD_REJECTED: return "Wert ungültig";
+    }
+    return "?";
+}
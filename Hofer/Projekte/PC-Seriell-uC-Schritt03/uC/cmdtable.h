@@ -0,0 +1,99 @@
+/*
+ * cmdtable.h - Kommando-Tabelle mit perfektem Hash, zur Compile-Zeit aufgebaut
+ *
+ * Statt jedes Kommando mit strcasecmp() der Reihe nach zu vergleichen, wird aus dem
+ * ersten Wort ein Hash gebildet, der direkt der Index in die Tabelle ist:
+ *
+ *   hash = (Länge * 3 + (erstes Zeichen & 31) * 25 + (letztes Zeichen & 31)) & 31
+ *
+ * "& 31" macht Groß- und Kleinbuchstaben gleich, der Hash ist also unabhängig von der
+ * Schreibweise. Danach wird nur noch EIN Vergleich mit dem Schlüsselwort gemacht, um
+ * unbekannte Wörter mit zufällig gleichem Hash abzuweisen -> O(1), egal wie viele
+ * Kommandos es gibt.
+ *
+ * Die Kommandos werden als X-Makro-Liste angegeben:
+ *
+ *   #define MY_COMMANDS(X)                                 \
+ *       X(SPEED, 'S', 'D', 1, 1, CMD_ARG_NUM(0), cmdSpeed) \
+ *       X(STOP,  'S', 'P', 0, 0, 0,              cmdStop)
+ *
+ *   Name, erstes und letztes Zeichen (als Zeichenkonstante, damit der Hash ein
+ *   konstanter Ausdruck ist), min./max. Anzahl Argumente, welche Argumente Zahlen sein
+ *   müssen, Handler.
+ *
+ *   static const CmdEntry table[CMD_TABLE_SIZE] = { MY_COMMANDS(CMD_ENTRY) };
+ *   CMD_CHECK_UNIQUE(MY_COMMANDS) // Hash-Kollision -> Compilerfehler "duplicate case value"
+ *
+ * Argumente werden beim Aufteilen direkt als Zahl geparst, der Handler bekommt fertige
+ * int32_t-Werte. Einheiten: "800NS" = 800, "2US" = 2000, "1MS" = 1000000 (Basis ns).
+ * Wörter (z.B. "ROT" bei "LED ROT") zeigen in den Kommandotext, es wird nichts kopiert.
+ */
+
+#ifndef CMDTABLE_H
+#define CMDTABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CMD_TABLE_SIZE 32 // Zweierpotenz
+#define CMD_MAX_ARGS 4
+
+#define CMD_HASH(len, first, last)                                                           \
+    ((((unsigned)(len) * 3u) + (((unsigned)(first) & 31u) * 25u) + ((unsigned)(last) & 31u)) \
+     & (CMD_TABLE_SIZE - 1))
+
+#define CMD_ARG_NUM(i) (1u << (i)) // Argument i muss eine Zahl sein
+
+// --- Geparste Argumente ---
+typedef struct {
+    int count;
+    uint8_t numberMask;             // Bit i gesetzt: Argument i ist eine gültige Zahl
+    int32_t value[CMD_MAX_ARGS];    // Zahlenwert (mit Einheit umgerechnet)
+    const char* word[CMD_MAX_ARGS]; // Anfang des Arguments im Kommandotext
+    uint8_t wordLen[CMD_MAX_ARGS];
+} CmdArgs;
+
+// Rückgabe 0 = ok, sonst ungültiger Wert
+typedef int (*CmdHandler)(const CmdArgs* args);
+
+typedef struct {
+    const char* name; // NULL = freier Platz
+    uint8_t len;
+    uint8_t minArgs;
+    uint8_t maxArgs;
+    uint8_t numberMask;
+    CmdHandler handler;
+} CmdEntry;
+
+typedef enum {
+    CMD_OK = 0,
+    CMD_EMPTY,    // nur Leerzeichen
+    CMD_UNKNOWN,  // Schlüsselwort nicht in der Tabelle
+    CMD_BAD_ARGS, // falsche Anzahl oder keine Zahl
+    CMD_REJECTED  // Handler hat den Wert abgelehnt
+} CmdResult;
+
+#define CMD_ENTRY(name, first, last, minArgs, maxArgs, numberMask, handler)                    \
+    [CMD_HASH(sizeof(#name) - 1, first, last)] = { #name, sizeof(#name) - 1, minArgs, maxArgs, \
+                                                   numberMask, handler },
+
+#define CMD_CASE(name, first, last, minArgs, maxArgs, numberMask, handler) \
+    case CMD_HASH(sizeof(#name) - 1, first, last):
+
+// Jeder Hash wird zu einem case-Label, doppelte Werte lehnt der Compiler ab
+#define CMD_CHECK_UNIQUE(list)                       \
+    static inline void cmdCheckUnique_##list(void) { \
+        switch (0) {                                 \
+        list(CMD_CASE) break;                        \
+        }                                            \
+    }
+
+// Kommando auswerten und Handler aufrufen. len = Länge von text (muss nicht nullterminiert sein).
+CmdResult cmdDispatch(const CmdEntry* table, const char* text, size_t len);
+
+// Wortargument vergleichen (ohne Groß-/Kleinschreibung)
+int cmdArgIs(const CmdArgs* args, int i, const char* word);
+
+const char* cmdResultText(CmdResult result);
+
+#endif
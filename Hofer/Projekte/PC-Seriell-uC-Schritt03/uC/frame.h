@@ -0,0 +1,81 @@
+/*
+ * frame.h - Binäres Rahmenprotokoll (Schritt03)
+ *
+ * Aufbau eines Rahmens:
+ *
+ *   | SYNC | TYPE | LEN | PAYLOAD (0..FRAME_MAX_PAYLOAD) | CRC_H | CRC_L |
+ *
+ *  - SYNC  = 0xA5, markiert den Rahmenbeginn
+ *  - TYPE  = Rahmentyp (siehe FrameType)
+ *  - LEN   = Anzahl der Nutzdatenbytes
+ *  - CRC   = CRC-16/CCITT-FALSE (Poly 0x1021, Start 0xFFFF) über TYPE, LEN und PAYLOAD,
+ *            höherwertiges Byte zuerst
+ *
+ * Mehrbytige Werte in den Nutzdaten sind Little Endian.
+ * Ein Sollwert-Rahmen ist 7 Bytes lang -> bei 115200 Baud (8N1) passen ca. 1600 Rahmen/s.
+ *
+ * Der Decoder arbeitet Byte für Byte (passt zu UART-Interrupt oder read()-Puffer).
+ * Die Nutzdaten werden beim Empfang genau einmal in den Rahmenpuffer des Decoders geschrieben,
+ * der Handler bekommt nur einen Zeiger darauf - es wird nichts umkopiert.
+ * Bei CRC- oder Längenfehler wird ab dem Byte nach dem falschen SYNC neu gesucht (Resync).
+ */
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FRAME_SYNC 0xA5
+#define FRAME_MAX_PAYLOAD 64
+#define FRAME_HEADER_LEN 3 // SYNC, TYPE, LEN
+#define FRAME_CRC_LEN 2
+#define FRAME_MAX_LEN (FRAME_HEADER_LEN + FRAME_MAX_PAYLOAD + FRAME_CRC_LEN)
+
+// --- Rahmentypen ---
+typedef enum {
+    FRAME_TYPE_CMD = 0x01,      // Textkommando als Nutzdaten (z.B. "LED ROT"), ohne '\0'
+    FRAME_TYPE_SETPOINT = 0x02, // Drehzahl-Sollwert: uint16 U/min
+    FRAME_TYPE_STOP = 0x03      // Motor stoppen, keine Nutzdaten
+} FrameType;
+
+// Wird für jeden gültigen Rahmen aufgerufen. payload zeigt in den Puffer des Decoders
+// und ist nur bis zum nächsten frameDecoderPush() gültig.
+typedef void (*FrameHandler)(uint8_t type, const uint8_t* payload, uint8_t len, void* ctx);
+
+// --- Statistik ---
+typedef struct {
+    uint32_t frames;      // gültige Rahmen
+    uint32_t crcErrors;   // Rahmen mit falscher Prüfsumme
+    uint32_t lenErrors;   // LEN > FRAME_MAX_PAYLOAD
+    uint32_t resyncBytes; // beim Resync verworfene Bytes
+} FrameStats;
+
+// --- Decoder-Zustand ---
+typedef struct {
+    uint8_t state;
+    uint8_t len;
+    uint8_t pos;                    // belegte Bytes in raw[]
+    uint16_t crc;                   // laufende CRC über TYPE, LEN, PAYLOAD
+    uint8_t raw[FRAME_MAX_LEN - 1]; // TYPE, LEN, PAYLOAD, CRC (ohne SYNC)
+    uint8_t replay[FRAME_MAX_LEN];  // nach Fehler noch einmal zu prüfende Bytes
+    uint8_t replayHead;
+    uint8_t replayLen;
+    FrameHandler handler;
+    void* ctx;
+    FrameStats stats;
+} FrameDecoder;
+
+uint16_t frameCrc16(uint16_t crc, const uint8_t* data, size_t len);
+
+void frameDecoderInit(FrameDecoder* dec, FrameHandler handler, void* ctx);
+
+// Ein empfangenes Byte verarbeiten.
+// Rückgabe 1: Byte gehört zum Rahmenprotokoll.
+// Rückgabe 0: Decoder wartet auf SYNC und das Byte ist kein SYNC -> darf als Text weiterverwendet werden.
+int frameDecoderPush(FrameDecoder* dec, uint8_t byte);
+
+// Rahmen in out[] (mind. FRAME_MAX_LEN Bytes) zusammenbauen, Rückgabe = Rahmenlänge oder 0 bei zu viel Nutzdaten
+size_t frameEncode(uint8_t type, const uint8_t* payload, uint8_t len, uint8_t* out);
+
+#endif
@@ -5,12 +5,34 @@
  * und wertet sie mit zwei Threads aus:
  *  1. Thread: Empfängt Strings und legt sie bei CR in eine Message Queue
  *  2. Thread: Liest Befehle aus der Queue und führt Aktionen aus
+ * Die Queue ist ein lock-freier SPSC-Ring (siehe cmdring.h).
  *
- * Unterstützte Befehle:
- *  - "LED ROT" oder "LED rot" -> rote LED an
- *  - "OFF" -> alle LEDs aus
+ * Unterstützte Befehle (Groß-/Kleinschreibung egal):
+ *  - "LED ROT" / "LED GRUEN" -> LED an
+ *  - "SPEED 1200"            -> Drehzahl-Sollwert in U/min
+ *  - "DUTY 75"               -> Tastverhältnis in %
+ *  - "DEADTIME 800NS"        -> Totzeit (Einheit NS, US oder MS, ohne Einheit ns)
+ *  - "STATS" / "STATS RESET" -> Laufzeitstatistik der Kommandoschleife ausgeben / löschen
  *
- * Weitere Befehle können leicht in parseCommand() hinzugefügt werden.
+ * Sicherheitskommandos mit Vorrang (PRIORITY_LIST):
+ *  - "STOP"                  -> Motor stoppen
+ *  - "OFF"                   -> Motor stoppen und alle LEDs aus
+ *  - "ESTOP"                 -> Not-Aus
+ * Sie werden schon im Empfangs-Thread erkannt und sofort ausgeführt, ohne hinter den Kommandos
+ * in der Queue zu warten. Alles, was vor dem Stopp in der Queue stand, wird danach verworfen,
+ * damit ein alter Sollwert den Motor nicht wieder anlaufen lässt.
+ *
+ * Weitere Befehle werden in COMMAND_LIST eingetragen (siehe cmdtable.h).
+ *
+ * Neben Textzeilen werden binäre Rahmen (siehe frame.h) verstanden:
+ *  - FRAME_TYPE_CMD      -> Textkommando, geht wie eine Zeile in die Queue
+ *  - FRAME_TYPE_SETPOINT -> Drehzahl-Sollwert, wird direkt übernommen (der neueste gilt)
+ *  - FRAME_TYPE_STOP     -> Motor stoppen
+ * Ein Byte 0xA5 (SYNC) startet einen Rahmen, alle anderen Bytes außerhalb eines Rahmens
+ * gehören zur Textzeile. Damit funktionieren alte Terminal-Befehle weiterhin.
+ *
+ * Aufruf:     ./uC /dev/ttyACM0   (ohne Argument wird von stdin gelesen)
+ * Übersetzen: gcc -O2 -Wall -o uC main.c frame.c cmdtable.c serialport.c -lpthread
  */
 
 #include <stdio.h>
@@ -19,84 +41,331 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
 
-#define QUEUE_SIZE 10
 #define CMD_MAX_LEN 64
+#define CMD_RING_TEXT_LEN CMD_MAX_LEN
+
+#include "frame.h"
+#include "cmdring.h"
+#include "cmdtable.h"
+#include "serialport.h"
+
+#define SERIAL_BAUD 115200
+
+CommandRing commandQueue;
+_Atomic uint32_t stopBarrier = 0; // Kommandos mit seq davor wurden durch einen Stopp ungültig
+// Hält der Auswerte-Thread, solange er ein Kommando ausführt; ein Stopp wartet darauf, damit
+// kein Kommando, das vor dem Stopp schon die Barriere passiert hat, danach noch ausgeführt wird
+static pthread_mutex_t dispatchLock = PTHREAD_MUTEX_INITIALIZER;
 
-char messageQueue[QUEUE_SIZE][CMD_MAX_LEN];
-int queueHead = 0;
-int queueTail = 0;
-pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t queueCond = PTHREAD_COND_INITIALIZER;
+// --- Statistik der Kommandoschleife (STATS / STATS RESET) ---
+// Histogramme mit festen Klassen, statisch angelegt; beschreibt nur der Auswerte-Thread
+#define STATS_BUCKETS 16
+
+typedef struct {
+    uint32_t bucket[STATS_BUCKETS]; // Klasse i = Wert i * Breite, letzte Klasse: alles darüber
+    uint32_t width;
+    uint32_t count;
+    uint32_t max;
+} Histogram;
+
+static Histogram execHist = { .width = 4 };  // Ausführungszeit je Kommando (us, Klassen à 4 us)
+static Histogram batchHist = { .width = 1 }; // Kommandos je Aufwachen (Rückstau in der Queue)
+static uint32_t cmdErrors = 0;               // unbekannt, falsche Argumente, Wert ungültig
+static uint32_t dropsAtReset = 0;            // Stand der Queue-Drops beim letzten STATS RESET
+static uint32_t tooLongAtReset = 0;          // Stand der zu langen Kommandos beim letzten STATS RESET
+static _Atomic uint32_t stopCount = 0;       // Sicherheitskommandos (Empfangs-Thread)
+
+static uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void histAdd(Histogram* h, uint32_t value) {
+    uint32_t i = value / h->width;
+    h->bucket[i < STATS_BUCKETS ? i : STATS_BUCKETS - 1]++;
+    h->count++;
+    if (value > h->max) {
+        h->max = value;
+    }
+}
+
+void histReset(Histogram* h) {
+    memset(h->bucket, 0, sizeof(h->bucket));
+    h->count = 0;
+    h->max = 0;
+}
+
+void histPrint(const char* name, const Histogram* h) {
+    printf("STATS %s: n=%u max=%u\n", name, h->count, h->max);
+    for (uint32_t i = 0; i < STATS_BUCKETS; i++) {
+        if (h->bucket[i] == 0) {
+            continue;
+        }
+        if (i == STATS_BUCKETS - 1) {
+            printf("  %u+: %u\n", i * h->width, h->bucket[i]);
+        } else {
+            printf("  %u..%u: %u\n", i * h->width, (i + 1) * h->width - 1, h->bucket[i]);
+        }
+    }
+}
 
 // --- LED Funktionen (simuliert) ---
 void ledRedOn() { printf("[LED] Rot an\n"); }
 void ledGreenOn() { printf("[LED] Gruen an\n"); }
 void allLedsOff() { printf("[LED] Alle aus\n"); }
 
+// --- Motor Funktionen (simuliert) ---
+void motorSetpoint(uint16_t rpm) { printf("[MOTOR] Sollwert %u U/min\n", rpm); }
+void motorStop(void) { printf("[MOTOR] Stopp\n"); }
+void motorEmergencyStop(void) { printf("[MOTOR] NOT-AUS\n"); }
+void motorDuty(int percent) { printf("[MOTOR] Tastverhaeltnis %d %%\n", percent); }
+void motorDeadtime(int ns) { printf("[MOTOR] Totzeit %d ns\n", ns); }
+
 // --- Hilfsfunktion zum Einfügen in die Queue ---
+// len: Länge des Kommandos (Nutzdaten eines Rahmens sind nicht nullterminiert)
+void enqueueCommandLen(const char* cmd, size_t len) {
+    if (cmdRingPush(&commandQueue, cmd, len)) {
+        return;
+    }
+    if (len > CMD_MAX_LEN - 1) {
+        // nie abgeschnitten ausführen: "SPEED 100", Leerzeichen, "9" wäre sonst SPEED 100
+        fprintf(stderr, "Kommando zu lang (%zu > %d Zeichen), verworfen\n", len, CMD_MAX_LEN - 1);
+    } else {
+        // Queue voll: Kommando wird verworfen (gezählt), nichts Ungelesenes überschrieben
+        fprintf(stderr, "Queue voll, Kommando verworfen (%u gesamt)\n", cmdRingDrops(&commandQueue));
+    }
+}
+
 void enqueueCommand(const char* cmd) {
-    pthread_mutex_lock(&queueMutex);
-    strncpy(messageQueue[queueTail], cmd, CMD_MAX_LEN-1);
-    messageQueue[queueTail][CMD_MAX_LEN-1] = '\0';
-    queueTail = (queueTail + 1) % QUEUE_SIZE;
-    pthread_cond_signal(&queueCond);
-    pthread_mutex_unlock(&queueMutex);
+    enqueueCommandLen(cmd, strlen(cmd));
+}
+
+// --- Kommando-Handler, Argumente sind bereits geparst ---
+int cmdLed(const CmdArgs* args) {
+    if (cmdArgIs(args, 0, "ROT")) {
+        ledRedOn();
+    } else if (cmdArgIs(args, 0, "GRUEN")) {
+        ledGreenOn();
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+int cmdSpeed(const CmdArgs* args) {
+    if (args->value[0] < 0 || args->value[0] > UINT16_MAX) {
+        return -1;
+    }
+    motorSetpoint((uint16_t)args->value[0]);
+    return 0;
 }
 
-// --- Hilfsfunktion zum Auslesen der Queue ---
-int dequeueCommand(char* buffer) {
-    pthread_mutex_lock(&queueMutex);
-    while (queueHead == queueTail) {
-        pthread_cond_wait(&queueCond, &queueMutex);
+int cmdDuty(const CmdArgs* args) {
+    if (args->value[0] < 0 || args->value[0] > 100) {
+        return -1;
     }
-    strncpy(buffer, messageQueue[queueHead], CMD_MAX_LEN);
-    queueHead = (queueHead + 1) % QUEUE_SIZE;
-    pthread_mutex_unlock(&queueMutex);
-    return 1;
+    motorDuty(args->value[0]);
+    return 0;
 }
 
+int cmdDeadtime(const CmdArgs* args) {
+    if (args->value[0] < 0 || args->value[0] > 10000) {
+        return -1; // mehr als 10 us ist sicher ein Tippfehler
+    }
+    motorDeadtime(args->value[0]);
+    return 0;
+}
+
+int cmdStats(const CmdArgs* args) {
+    if (args->count == 1) {
+        if (!cmdArgIs(args, 0, "RESET")) {
+            return -1;
+        }
+        histReset(&execHist);
+        histReset(&batchHist);
+        cmdErrors = 0;
+        dropsAtReset = cmdRingDrops(&commandQueue);
+        tooLongAtReset = cmdRingTooLong(&commandQueue);
+        atomic_store(&stopCount, 0);
+        printf("STATS reset\n");
+        return 0;
+    }
+    histPrint("exec_us", &execHist);
+    histPrint("batch", &batchHist);
+    printf("STATS errors=%u drops=%u highwater=%u stops=%u\n",
+           cmdErrors + cmdRingTooLong(&commandQueue) - tooLongAtReset, cmdRingDrops(&commandQueue) - dropsAtReset, cmdRingHighWater(&commandQueue),
+           atomic_load(&stopCount));
+    return 0;
+}
+
+// --- Sicherheitskommandos, laufen im Empfangs-Thread ---
+// Alles, was bis jetzt in der Queue steht, ist durch den Stopp überholt. Erst die Barriere
+// setzen, dann auf ein gerade laufendes Kommando warten (höchstens eine Ausführung lang),
+// erst danach abschalten: so kann kein alter Sollwert den Motor nach dem Stopp wieder starten.
+void stopWith(void (*stop)(void)) {
+    atomic_store(&stopBarrier, cmdRingHead(&commandQueue));
+    pthread_mutex_lock(&dispatchLock);
+    stop();
+    pthread_mutex_unlock(&dispatchLock);
+    atomic_fetch_add(&stopCount, 1);
+}
+
+void safetyStop() {
+    stopWith(motorStop);
+}
+
+int cmdStop(const CmdArgs* args) {
+    (void)args;
+    safetyStop();
+    return 0;
+}
+
+int cmdOff(const CmdArgs* args) {
+    (void)args;
+    safetyStop();
+    allLedsOff();
+    return 0;
+}
+
+int cmdEstop(const CmdArgs* args) {
+    (void)args;
+    stopWith(motorEmergencyStop);
+    return 0;
+}
+
+#define PRIORITY_LIST(X)                  \
+    X(STOP,  'S', 'P', 0, 0, 0, cmdStop)  \
+    X(OFF,   'O', 'F', 0, 0, 0, cmdOff)   \
+    X(ESTOP, 'E', 'P', 0, 0, 0, cmdEstop)
+
+static const CmdEntry priorityTable[CMD_TABLE_SIZE] = { PRIORITY_LIST(CMD_ENTRY) };
+CMD_CHECK_UNIQUE(PRIORITY_LIST)
+
+// --- Kommandoliste: Name, erstes/letztes Zeichen, min./max. Argumente, Zahl-Argumente, Handler ---
+#define COMMAND_LIST(X)                                      \
+    X(LED,      'L', 'D', 1, 1, 0,              cmdLed)      \
+    X(SPEED,    'S', 'D', 1, 1, CMD_ARG_NUM(0), cmdSpeed)    \
+    X(DUTY,     'D', 'Y', 1, 1, CMD_ARG_NUM(0), cmdDuty)     \
+    X(DEADTIME, 'D', 'E', 1, 1, CMD_ARG_NUM(0), cmdDeadtime) \
+    X(STATS,    'S', 'S', 0, 1, 0,              cmdStats)
+
+static const CmdEntry commandTable[CMD_TABLE_SIZE] = { COMMAND_LIST(CMD_ENTRY) };
+CMD_CHECK_UNIQUE(COMMAND_LIST)
+
 // --- Befehlsauswertung ---
-void parseCommand(const char* cmd) {
-    if (strcasecmp(cmd, "LED ROT") == 0 || strcasecmp(cmd, "LED rot") == 0) {
-        ledRedOn();
-    } else if (strcasecmp(cmd, "OFF") == 0) {
-        allLedsOff();
-    } else {
-        printf("Unbekannter Befehl: %s\n", cmd);
+void parseCommand(const char* cmd, size_t len) {
+    CmdResult result = cmdDispatch(commandTable, cmd, len);
+    if (result != CMD_OK && result != CMD_EMPTY) {
+        cmdErrors++;
+        printf("%s: %.*s\n", cmdResultText(result), (int)len, cmd);
     }
 }
 
-// --- Thread: Empfängt Daten (Simulation statt echte UART) ---
-void* receiverThread(void* arg) {
-    char buffer[CMD_MAX_LEN];
-    while (1) {
-        if (fgets(buffer, sizeof(buffer), stdin)) {
-            buffer[strcspn(buffer, "\r\n")] = '\0';
-            if (strlen(buffer) > 0) {
-                enqueueCommand(buffer);
-            }
+// --- Neues Kommando vom Empfang: Sicherheitskommandos sofort, alles andere in die Queue ---
+void submitCommand(const char* cmd, size_t len) {
+    CmdResult result = cmdDispatch(priorityTable, cmd, len); // ein Hash-Zugriff
+    if (result == CMD_UNKNOWN || result == CMD_EMPTY) {
+        enqueueCommandLen(cmd, len);
+    } else if (result != CMD_OK) {
+        printf("%s: %.*s\n", cmdResultText(result), (int)len, cmd);
+    }
+}
+
+// --- Auswertung binärer Rahmen ---
+// payload zeigt direkt in den Empfangspuffer des Decoders
+void onFrame(uint8_t type, const uint8_t* payload, uint8_t len, void* ctx) {
+    (void)ctx;
+    switch (type) {
+    case FRAME_TYPE_CMD:
+        if (len > 0) {
+            submitCommand((const char*)payload, len);
         }
-        usleep(10000);
+        break;
+    case FRAME_TYPE_SETPOINT:
+        // Sollwerte kommen mit hoher Rate -> nicht über die Queue, sondern sofort übernehmen
+        if (len == 2) {
+            pthread_mutex_lock(&dispatchLock); // nicht gleichzeitig mit einem Kommando aus der Queue
+            motorSetpoint((uint16_t)(payload[0] | (payload[1] << 8)));
+            pthread_mutex_unlock(&dispatchLock);
+        }
+        break;
+    case FRAME_TYPE_STOP:
+        safetyStop();
+        break;
+    default:
+        printf("Unbekannter Rahmentyp: 0x%02X\n", type);
+        break;
     }
-    return NULL;
+}
+
+// --- Empfang: Rahmenbytes zum Decoder, Textzeilen in die Queue ---
+int frameFilter(uint8_t byte, void* ctx) {
+    return frameDecoderPush((FrameDecoder*)ctx, byte);
+}
+
+void onLine(const char* line, size_t len, void* ctx) {
+    (void)ctx;
+    submitCommand(line, len); // Zeiger direkt in den Empfangspuffer
+}
+
+// --- Thread: Empfängt Daten von der seriellen Schnittstelle ---
+// Blockiert in poll(), bis Daten da sind, und verarbeitet dann alles auf einmal
+void* receiverThread(void* arg) {
+    int fd = *(int*)arg;
+    static FrameDecoder decoder;
+    static SerialReader reader;
+
+    frameDecoderInit(&decoder, onFrame, NULL);
+    serialReaderInit(&reader, fd, frameFilter, onLine, &decoder);
+
+    while (serialReaderPoll(&reader, -1) >= 0) {
+        // kein Sleep: poll() wartet, bis wieder etwas ankommt
+    }
+    return NULL; // Dateiende oder Gerät getrennt
 }
 
 // --- Thread: Liest Queue und wertet Kommandos aus ---
+void onCommand(const Command* cmd, void* ctx) {
+    (void)ctx;
+    pthread_mutex_lock(&dispatchLock);
+    // Prüfung unter der Sperre: ein Stopp setzt die Barriere, bevor er sie nimmt
+    if ((int32_t)(cmd->seq - atomic_load(&stopBarrier)) < 0) {
+        pthread_mutex_unlock(&dispatchLock);
+        return; // vor einem Stopp eingegangen -> verwerfen
+    }
+    uint64_t start = nowNs();
+    parseCommand(cmd->text, cmd->len); // direkt aus dem Ring, ohne Kopie
+    pthread_mutex_unlock(&dispatchLock);
+    histAdd(&execHist, (uint32_t)((nowNs() - start) / 1000));
+}
+
 void* commandThread(void* arg) {
-    char buffer[CMD_MAX_LEN];
     while (1) {
-        if (dequeueCommand(buffer)) {
-            parseCommand(buffer);
-        }
+        cmdRingWait(&commandQueue); // schläft nur, wenn die Queue leer ist
+        size_t n = cmdRingPopBatch(&commandQueue, onCommand, NULL, CMD_RING_SIZE);
+        histAdd(&batchHist, (uint32_t)n);
     }
     return NULL;
 }
 
-int main() {
+int main(int argc, char** argv) {
     pthread_t recvThread, cmdThread;
+    int fd = STDIN_FILENO; // ohne Argument: Eingabe über das Terminal
+
+    if (argc > 1) {
+        fd = serialOpen(argv[1], SERIAL_BAUD);
+        if (fd < 0) {
+            return 1;
+        }
+    }
 
-    pthread_create(&recvThread, NULL, receiverThread, NULL);
+    cmdRingInit(&commandQueue);
+    pthread_create(&recvThread, NULL, receiverThread, &fd);
     pthread_create(&cmdThread, NULL, commandThread, NULL);
 
     pthread_join(recvThread, NULL);
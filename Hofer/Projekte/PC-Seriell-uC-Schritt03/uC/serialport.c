@@ -0,0 +1,132 @@
+/*
+ * serialport.c - Serielle Schnittstelle mit termios, poll() und blockweisem read()
+ */
+
+#include "serialport.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+static speed_t baudToSpeed(int baud) {
+    switch (baud) {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default:     return 0;
+    }
+}
+
+int serialConfigure(int fd, int baud) {
+    struct termios tio;
+    speed_t speed = baudToSpeed(baud);
+
+    if (speed == 0 || tcgetattr(fd, &tio) != 0) {
+        return -1;
+    }
+    cfmakeraw(&tio); // keine Zeilenpufferung, kein Echo, keine Zeichenumwandlung
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    // read() kehrt zurück, sobald mindestens ein Byte da ist; gewartet wird mit poll()
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        return -1;
+    }
+    tcflush(fd, TCIFLUSH);
+    return 0;
+}
+
+int serialOpen(const char* path, int baud) {
+    int fd = open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    if (serialConfigure(fd, baud) != 0) {
+        fprintf(stderr, "%s: termios/Baudrate %d nicht möglich\n", path, baud);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void serialReaderInit(SerialReader* rd, int fd, SerialByteFilter filter, SerialLineHandler onLine, void* ctx) {
+    memset(rd, 0, sizeof(*rd));
+    rd->fd = fd;
+    rd->filter = filter;
+    rd->onLine = onLine;
+    rd->ctx = ctx;
+}
+
+int serialReaderPoll(SerialReader* rd, int timeoutMs) {
+    struct pollfd pfd = { .fd = rd->fd, .events = POLLIN };
+
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+    if (ready == 0) {
+        return 0; // Timeout
+    }
+
+    // Alles abholen, was seit dem letzten Mal angekommen ist - direkt hinter den angefangenen Text
+    ssize_t n = read(rd->fd, rd->buf + rd->textEnd, sizeof(rd->buf) - rd->textEnd);
+    if (n <= 0) {
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+            return 0;
+        }
+        return -1; // Dateiende oder Gerät weg
+    }
+    rd->stats.bytes += (uint32_t)n;
+    rd->stats.reads++;
+
+    // --- Zeilen im Puffer trennen ---
+    // Textbytes werden nach vorne zusammengeschoben (nur nötig, wenn Rahmenbytes dazwischen waren),
+    // textEnd ist dabei nie größer als die Leseposition.
+    size_t end = rd->textEnd + (size_t)n;
+    for (size_t i = rd->textEnd; i < end; i++) {
+        uint8_t ch = rd->buf[i];
+        if (rd->filter && rd->filter(ch, rd->ctx)) {
+            continue; // Byte gehört z.B. zu einem binären Rahmen
+        }
+        if (ch == '\r' || ch == '\n') {
+            if (rd->discard) {
+                rd->discard = 0;
+            } else if (rd->textEnd > rd->lineStart) {
+                rd->onLine((const char*)&rd->buf[rd->lineStart], rd->textEnd - rd->lineStart, rd->ctx);
+                rd->stats.lines++;
+            }
+            rd->lineStart = rd->textEnd;
+        } else if (ch >= 32 && ch <= 126 && !rd->discard) {
+            if (rd->textEnd != i) {
+                rd->buf[rd->textEnd] = ch;
+            }
+            rd->textEnd++;
+        }
+    }
+
+    // --- Angefangene Zeile an den Pufferanfang ---
+    size_t rest = rd->textEnd - rd->lineStart;
+    if (rest > SERIAL_MAX_LINE) {
+        rd->stats.longLines++;
+        rd->discard = 1;
+        rest = 0;
+    } else if (rest > 0 && rd->lineStart > 0) {
+        memmove(rd->buf, rd->buf + rd->lineStart, rest);
+    }
+    rd->lineStart = 0;
+    rd->textEnd = rest;
+    return (int)n;
+}
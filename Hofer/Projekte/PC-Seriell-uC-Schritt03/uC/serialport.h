@@ -0,0 +1,60 @@
+/*
+ * serialport.h - Serielle Schnittstelle öffnen und blockweise lesen
+ *
+ * Ersetzt das zeichenweise getchar() + usleep():
+ *  - serialOpen() öffnet ein tty (oder pty) und stellt es mit termios auf "raw" und die Baudrate
+ *  - serialReaderPoll() wartet mit poll() bis Daten da sind und holt mit EINEM read()
+ *    alles ab, was inzwischen angekommen ist (bis SERIAL_RX_BUF Bytes)
+ *  - Textzeilen werden direkt im Empfangspuffer getrennt (CR oder LF), der Handler bekommt
+ *    Zeiger + Länge in den Puffer. Nur ein angefangener Rest wird an den Pufferanfang geschoben.
+ *  - Ein optionaler Byte-Filter (z.B. der Rahmen-Decoder aus frame.h) sieht jedes Byte zuerst;
+ *    Bytes, die er übernimmt, gehören nicht zur Textzeile.
+ */
+
+#ifndef SERIALPORT_H
+#define SERIALPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SERIAL_RX_BUF 4096
+#define SERIAL_MAX_LINE 256 // längere Zeilen ohne Zeilenende werden verworfen
+
+// Rückgabe 1: Byte übernommen (kein Text), 0: Byte gehört zur Textzeile
+typedef int (*SerialByteFilter)(uint8_t byte, void* ctx);
+
+// Zeile ohne Zeilenende, nicht nullterminiert, nur während des Aufrufs gültig
+typedef void (*SerialLineHandler)(const char* line, size_t len, void* ctx);
+
+typedef struct {
+    uint32_t bytes;     // empfangene Bytes
+    uint32_t reads;     // read()-Aufrufe mit Daten
+    uint32_t lines;     // weitergegebene Zeilen
+    uint32_t longLines; // verworfene überlange Zeilen
+} SerialStats;
+
+typedef struct {
+    int fd;
+    SerialByteFilter filter;
+    SerialLineHandler onLine;
+    void* ctx;
+    size_t lineStart; // Beginn der aktuellen Zeile in buf
+    size_t textEnd;   // Ende des bisher gesammelten Texts in buf
+    int discard;      // Rest einer überlangen Zeile bis zum Zeilenende ignorieren
+    uint8_t buf[SERIAL_RX_BUF];
+    SerialStats stats;
+} SerialReader;
+
+// tty/pty öffnen, raw 8N1 mit baud einstellen. Rückgabe fd oder -1.
+int serialOpen(const char* path, int baud);
+
+// Vorhandenes fd konfigurieren (z.B. Slave-Seite eines pty), Rückgabe 0 = ok
+int serialConfigure(int fd, int baud);
+
+void serialReaderInit(SerialReader* rd, int fd, SerialByteFilter filter, SerialLineHandler onLine, void* ctx);
+
+// Einmal warten (timeoutMs, -1 = unbegrenzt) und alles Vorhandene verarbeiten.
+// Rückgabe: Anzahl gelesener Bytes, 0 bei Timeout, -1 bei Dateiende oder Fehler.
+int serialReaderPoll(SerialReader* rd, int timeoutMs);
+
+#endif
@@ -0,0 +1,70 @@
+// bemf.c
+// Nulldurchgangserkennung der Gegen-EMK (sensorless 6-Step).
+// In jedem Schritt ist genau eine Phase offen (weder HS noch LS aktiv). Ihre Spannung
+// läuft während der 60° el. linear von einer Versorgungsschiene zur anderen und kreuzt
+// in der Mitte (30° nach der Kommutation) den Sternpunkt. Steigend oder fallend ergibt
+// sich daraus, ob die Phase im vorherigen Schritt Low-Side oder High-Side war.
+
+#include "bemf.h"
+#include "bldc.h"
+#include "config.h"
+
+// Offene Phase je Schritt: die Phase, die in der COMMUTATION-Zeile nicht vorkommt
+#define FLOAT_PHASE_ENTRY(hs, ls) (3 - (hs) - (ls)),
+static const uint8_t FLOAT_PHASE[6] = {COMMUTATION_SEQUENCE(FLOAT_PHASE_ENTRY)};
+
+// jüngster Wert je Phase, mit CURRENT_SENSE danach der Strom (schreibt die DMA)
+static volatile uint16_t adc_sample[BEMF_ADC_INPUTS + CURRENT_SENSE];
+static bool rising[6]; // erwartete Flanke der offenen Phase je Schritt
+
+static uint8_t float_phase; // offene Phase im aktuellen Schritt
+static bool expect_rising;  // Flanke im aktuellen Schritt
+static bool seen_before;    // Phase lag schon auf der Seite vor dem Nulldurchgang
+static bool polled;         // im aktuellen Schritt schon abgefragt (erster Wert nach der Ausblendzeit?)
+
+void bemf_init(void)
+{
+    // steigend, wenn die offene Phase im vorherigen Schritt an der Low-Side lag
+    for (int s = 0; s < 6; ++s)
+        rising[s] = COMMUTATION[(s + 5) % 6][1] == FLOAT_PHASE[s];
+
+    hal_adc_stream_start(adc_sample, BEMF_ADC_INPUTS + CURRENT_SENSE);
+}
+
+const volatile uint16_t *bemf_adc_samples(void)
+{
+    return adc_sample;
+}
+
+void bemf_begin_step(int step)
+{
+    float_phase = FLOAT_PHASE[step];
+    expect_rising = rising[step];
+    seen_before = false;
+    polled = false;
+}
+
+bool bemf_zero_crossed(void)
+{
+    // Kopie der drei Werte; die DMA überschreibt sie laufend (je Wert < 2 µs alt)
+    int32_t a = adc_sample[0];
+    int32_t b = adc_sample[1];
+    int32_t c = adc_sample[2];
+    int32_t v = float_phase == 0 ? a : float_phase == 1 ? b : c;
+    int32_t diff = 3 * v - (a + b + c); // 3 * (Phase - Sternpunkt), ohne Division
+
+    // bei fallender Flanke Vorzeichen drehen -> Nulldurchgang immer von negativ nach positiv
+    if (!expect_rising)
+        diff = -diff;
+
+    bool first = !polled;
+    polled = true;
+    if (diff < -3 * (int32_t)BEMF_ZC_HYST)
+    {
+        seen_before = true; // noch vor dem Nulldurchgang
+        return false;
+    }
+    // Liegt schon der erste Wert nach der Ausblendzeit jenseits, eilt der Rotor vor und der
+    // Nulldurchgang fiel in die Ausblendzeit: sofort melden, sonst käme er erst im nächsten Schritt
+    return (seen_before || first) && diff > 3 * (int32_t)BEMF_ZC_HYST;
+}
@@ -0,0 +1,26 @@
+// bemf.h
+// Sensorless-Erkennung über die Gegen-EMK (Back-EMF) der gerade nicht bestromten Phase.
+// Der ADC tastet alle drei Phasen frei laufend per DMA ab; bemf_zero_crossed() vergleicht
+// die offene Phase mit dem virtuellen Sternpunkt (Mittelwert aller drei Phasen).
+// Das Timing (Ausblendzeit, 30° Verzögerung, Rückfall auf Open-Loop) macht comm_sched.c.
+
+#ifndef BEMF_H
+#define BEMF_H
+
+#include "hal.h"
+
+// ADC + DMA starten (einmalig, vor comm_scheduler_start)
+void bemf_init(void);
+
+// Puffer der ADC-DMA: [0..2] Phasen A,B,C, mit CURRENT_SENSE [3] Strom (siehe current.c)
+const volatile uint16_t *bemf_adc_samples(void);
+
+// Nach jeder Kommutation aufrufen: merkt sich offene Phase und erwartete Flanke des Schritts
+void bemf_begin_step(int step);
+
+// true beim ersten Abtastwert jenseits des Sternpunkts (mit Hysterese), nachdem die offene
+// Phase im aktuellen Schritt mindestens einmal auf der Seite vor dem Nulldurchgang lag. Ist
+// schon die erste Abfrage des Schritts jenseits, war der Nulldurchgang in der Ausblendzeit -> true.
+bool bemf_zero_crossed(void);
+
+#endif // BEMF_H
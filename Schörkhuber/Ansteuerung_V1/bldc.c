@@ -0,0 +1,463 @@
+// bldc.c
+// Leistungsstufe und 6-Step Kommutation, aus main.c herausgelöst, damit die
+// Steuerlogik ohne main() auch im Host-Build (host/) gebaut werden kann.
+
+#include "bldc.h"
+#include "config.h"
+#include "deadtime_pio.h"
+#include "perf.h"
+#include "pwm_engine.h"
+
+#if BLDC_DEADTIME_PIO && defined(BLDC_HOST)
+#error "BLDC_DEADTIME_PIO benötigt die RP2040-PIO und ist im Host-Build nicht verfügbar"
+#endif
+
+#if BLDC_DEADTIME_PIO && MOTOR_COUNT > 1
+#error "BLDC_DEADTIME_PIO spielt die Sequenz eines Motors ab (PIO0 SM0..3), MOTOR_COUNT muss 1 sein"
+#endif
+
+// Motor-Instanzen; Pins aus MOTOR_PINS (config.h), der Rest wird in bldc_init/comm_scheduler_init gesetzt
+motor_t motors[MOTOR_COUNT];
+
+#define MOTOR_PIN_ENTRY(hs_a, hs_b, hs_c, ls_a, ls_b, ls_c, fault) {{hs_a, hs_b, hs_c}, {ls_a, ls_b, ls_c}, fault},
+static const struct
+{
+    uint8_t hs[3];
+    uint8_t ls[3];
+    uint8_t fault;
+} MOTOR_PIN_TABLE[] = {MOTOR_PINS(MOTOR_PIN_ENTRY)};
+
+_Static_assert(MOTOR_COUNT >= 1 && MOTOR_COUNT <= sizeof(MOTOR_PIN_TABLE) / sizeof(MOTOR_PIN_TABLE[0]),
+               "MOTOR_PINS braucht eine Zeile je Motor");
+
+// -------------------- Schaltmasken --------------------
+// Statt jeden Pin einzeln per gpio_set_function/gpio_set_dir/gpio_put umzuschalten,
+// bleiben die Pin-Funktionen nach bldc_init() fest:
+//  - HS-Pins: SIO mit Ausgangswert 0. Ein/Aus nur über das SIO-Richtungsregister
+//    (Ausgang = Gate auf 0V = ON, Eingang = hochohmig = OFF). Alle drei HS werden
+//    mit EINEM gpio_set_dir_masked() gleichzeitig umgeschaltet.
+//  - LS-Pins: dauerhaft PWM. Ein/Aus über den Output-Enable-Override des Pins
+//    (GPIO_OVERRIDE_LOW = Treiber aus = hochohmig wie bisher "Input", NORMAL = PWM treibt).
+//    Der Duty steht permanent im CC-Register aller drei Slices; ein PWM-Slice nur
+//    anzuhalten wäre nicht sicher, da der Ausgang dann auf dem letzten Pegel stehen bleibt.
+// Die Masken je Motor (hs_mask, hs_all_mask, ls_slice/ls_chan) berechnet bldc_init einmal aus
+// den Pins, im Betrieb sind es reine Tabellenzugriffe.
+
+#define BIT(pin) (1u << (pin))
+
+// PWM-Slice/Kanal eines Pins wie im RP2040 (pwm_gpio_to_slice_num / pwm_gpio_to_channel)
+#define SLICE_OF(pin) (((pin) >> 1u) & 7u)
+#define CHAN_OF(pin) ((pin) & 1u)
+
+// Aus derselben Sequenz erzeugt wie die PIO-Tabellen, damit nichts auseinanderlaufen kann
+#define COMMUTATION_ENTRY(hs, ls) {(hs), (ls)},
+
+static uint32_t hs_all_motors_mask; // HS-Pins aller Motoren (E-Stop: ein Schreibzugriff)
+static uint32_t fault_pins_mask;    // FAULT-Eingänge aller Motoren
+
+// -------------------- Interne Helpers --------------------
+// Diese Hilfsfunktionen kapseln Hardwareaktionen (HS/LS ein/aus, PWM set).
+
+// HS umschalten: genau die HS-Pins in hs_mask werden Ausgang (LOW -> P‑MOSFET ON),
+// alle anderen HS des Motors hochohmig (externes Pullup -> P‑MOSFET OFF). Ein Registerzugriff.
+static inline void hs_drive_mask(motor_t *m, uint32_t hs_mask)
+{
+    hal_gpio_set_dir_masked(m->hs_all_mask, hs_mask);
+    // Achtung: interne Pulls sind deaktiviert (siehe init), wir verlassen uns auf externe 5V Pullups
+}
+
+// LS PWM deaktivieren: Ausgangstreiber per Override abschalten -> Pin hochohmig -> sicher
+static inline void ls_pwm_disable(motor_t *m, unsigned phase)
+{
+    hal_gpio_set_oeover(m->ls_pin[phase], GPIO_OVERRIDE_LOW);
+}
+
+// LS Duty setzen (nur bei Änderung), höchstens level_limit; schaltet nichts ein, der Treiber
+// bleibt wie er ist
+static inline void ls_pwm_set_level(motor_t *m, unsigned phase, uint16_t level)
+{
+    m->ls_req[phase] = level;
+    if (level > m->level_limit)
+        level = m->level_limit;
+    if (m->ls_level[phase] != level)
+    {
+        pwm_engine_set_level(m->ls_slice[phase], m->ls_chan[phase], level); // setze Duty (0..PWM_WRAP)
+        m->ls_level[phase] = level;
+    }
+}
+
+// LS PWM aktivieren: Duty setzen und Ausgangstreiber freigeben
+static inline void ls_pwm_enable(motor_t *m, unsigned phase, uint16_t level)
+{
+    ls_pwm_set_level(m, phase, level);
+    hal_gpio_set_oeover(m->ls_pin[phase], GPIO_OVERRIDE_NORMAL);
+}
+
+// Schalte alle Ausgänge des Motors in sicheren Zustand (OFF)
+void all_off(motor_t *m)
+{
+#if BLDC_DEADTIME_PIO
+    deadtime_pio_all_off(); // PIO-Sequenz verwerfen, alle sechs Pins hochohmig
+    m->current_step = -1;   // nächster Schritt ohne SEQ_PREV: alter HS ist schon aus
+#else
+    hs_drive_mask(m, 0); // alle HS hochohmig (aus) – ein Registerzugriff
+    for (int i = 0; i < 3; ++i)
+        ls_pwm_disable(m, i); // LS Treiber aus
+    m->sine_hs = 3;           // Sinus-Betrieb beginnt wieder ohne eingeschalteten HS
+    m->sine_stage = 0;
+#endif
+}
+
+// Busy-wait Deadtime (software Delay)
+// Hinweis: commutate_step läuft im Timer-Interrupt, dort darf nicht sleep_us (braucht selbst
+// einen Alarm) verwendet werden -> reines Busy-Wait auf den 1 MHz Timer.
+static inline void deadtime_delay_us(uint32_t us)
+{
+    uint32_t start = hal_cycles();
+    hal_busy_wait_us(us);                                       // blockiert die CPU für 'us' Mikrosekunden
+    perf_add(PERF_DEADTIME, (int32_t)perf_cycles_since(start)); // tatsächliche Wartezeit (STATS)
+}
+
+// Prüfe ob E-Stop oder der FAULT-Eingang des Motors aktiv ist.
+// is_fault_active gibt true zurück wenn einer der Sicherheitszustände gesetzt ist.
+bool is_fault_active(const motor_t *m)
+{
+    if (!hal_gpio_get(ESTOP_PIN)) // gpio_get liefert 0 wenn Pin LOW -> active LOW E-Stop gedrückt
+        return true;
+    if (m->fault_pin != MOTOR_NO_PIN && hal_gpio_get(m->fault_pin)) // FAULT active HIGH -> 1 bedeutet Fehler
+        return true;
+    return false; // kein Fehler
+}
+
+// Duty sofort ändern, ohne auf die nächste Kommutation zu warten (Drehzahlregler).
+// Es wird nur das CC-Register geschrieben, nie der Output-Enable: ein Aufruf aus einem
+// niedriger priorisierten Interrupt kann daher keinen abgeschalteten LS wieder einschalten.
+// Alle drei Phasen bekommen den Wert, dann muss commutate_step ihn nicht mehr schreiben.
+void bldc_set_level(motor_t *m, uint16_t pwm_level)
+{
+#if BLDC_DEADTIME_PIO
+    (void)m;
+    deadtime_pio_set_level(pwm_level);
+#else
+    for (unsigned i = 0; i < 3; ++i)
+        ls_pwm_set_level(m, i, pwm_level);
+#endif
+}
+
+// Aufruf aus dem PWM-Wrap-Interrupt der Strombegrenzung (gleiche Priorität wie die Kommutation,
+// unterbricht also nur den Drehzahlregler). Schreibt der Regler gerade mit der alten Grenze,
+// steht sein Wert höchstens bis zum nächsten Wrap im CC-Register: dann setzt current.c die
+// Grenze erneut.
+void bldc_set_level_limit(motor_t *m, uint16_t limit)
+{
+#if BLDC_DEADTIME_PIO
+    (void)m;
+    (void)limit; // PIO-PWM hat keinen Wrap-Interrupt, Strombegrenzung dort nicht möglich
+#else
+    m->level_limit = limit;
+    for (unsigned i = 0; i < 3; ++i)
+        ls_pwm_set_level(m, i, m->ls_req[i]);
+#endif
+}
+
+uint16_t bldc_level_applied(const motor_t *m)
+{
+    uint16_t l = m->ls_level[0];
+    if (m->ls_level[1] > l)
+        l = m->ls_level[1];
+    if (m->ls_level[2] > l)
+        l = m->ls_level[2];
+    return l;
+}
+
+bool bldc_fault_latched(const motor_t *m)
+{
+    return m->fault_latched;
+}
+
+// Aufruf aus dem Fault-Interrupt (höchste Priorität). Das Latch wird zuerst gesetzt, damit ein
+// unterbrochenes commutate_step danach nichts mehr einschaltet. Die HS gehen mit einem einzigen
+// SIO-Schreibzugriff (gpio_oe_clr) aus: ohne HS gibt es keinen Strompfad von der Versorgung.
+void bldc_emergency_off(motor_t *m)
+{
+    m->fault_latched = true;
+#if BLDC_DEADTIME_PIO
+    deadtime_pio_all_off(); // Pins gehören der PIO, SIO-Richtung wirkt dort nicht
+    m->current_step = -1;   // sonst schaltet der nächste Schritt den alten HS kurz wieder ein
+#else
+    hal_gpio_set_dir_in_masked(m->hs_all_mask); // alle HS hochohmig (aus) – ein Schreibzugriff
+    for (int i = 0; i < 3; ++i)
+        ls_pwm_disable(m, i); // LS Treiber aus
+#endif
+}
+
+// E-Stop: zuerst alle Latches, dann die HS aller Motoren in einem Schreibzugriff
+void bldc_emergency_off_all(void)
+{
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+        motors[i].fault_latched = true;
+#if BLDC_DEADTIME_PIO
+    deadtime_pio_all_off();
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+        motors[i].current_step = -1;
+#else
+    hal_gpio_set_dir_in_masked(hs_all_motors_mask);
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+        for (int p = 0; p < 3; ++p)
+            ls_pwm_disable(&motors[i], p);
+#endif
+}
+
+bool bldc_fault_clear(motor_t *m)
+{
+    if (is_fault_active(m))
+        return false; // Fehler liegt noch an
+    m->fault_latched = false;
+    return true;
+}
+
+uint32_t bldc_fault_pins_mask(void)
+{
+    return fault_pins_mask;
+}
+
+// -------------------- Kommutationslogik --------------------
+// 6-Schritt Sequenz (trapezoidal), erzeugt aus COMMUTATION_SEQUENCE (bldc.h).
+// Jede Zeile {HS_phase, LS_phase}: z.B. {0,1} = HS Phase A on, LS Phase B PWM, Phase C floating.
+const int COMMUTATION[6][2] = {COMMUTATION_SEQUENCE(COMMUTATION_ENTRY)};
+
+// commutate_step führt eine Kommutationsstufe eines Motors sicher aus.
+// step: Index 0..5, pwm_level: Duty Wert (0..PWM_WRAP)
+// Ablauf: LS aus -> Totzeit -> alle HS gleichzeitig umschalten -> Totzeit -> LS ein.
+// Die frühere getrennte Totzeit zwischen "andere HS aus" und "neuer HS ein" entfällt,
+// weil beide Flanken jetzt im selben Registerzugriff passieren (zwei HS verschiedener
+// Phasen können ohnehin keinen Brückenkurzschluss erzeugen).
+// Mit BLDC_DEADTIME_PIO spielt die PIO denselben Ablauf taktgenau ab, die Funktion
+// kehrt dann ohne Wartezeit zurück.
+// Fehler: statt die Fault-Pins bei jedem Schritt zu lesen, wird nur das Latch geprüft, das der
+// Fault-Interrupt setzt. Jeder Einschaltvorgang passiert mit kurz gesperrten Interrupts direkt
+// nach einer erneuten Prüfung des Latches, so kann ein Fault mitten im Schritt nichts mehr
+// einschalten lassen (Sperre: ein Registerzugriff lang).
+// Die Dauer bis "Ausgänge geschaltet" geht in die Laufzeitmessung (perf.h, PERF_COMMUTATE).
+#if BLDC_DEADTIME_PIO
+void commutate_step(motor_t *m, int step, uint16_t pwm_level)
+{
+    uint32_t start = hal_cycles();
+
+    // Fehler gespeichert -> Ausgänge sind schon aus, nichts schalten
+    if (m->fault_latched)
+    {
+        m->current_step = -1; // Zustandsmerker zurücksetzen
+        return;               // verlasse Funktion ohne Umschalten
+    }
+
+    deadtime_pio_set_level(pwm_level); // Duty (wirkt am nächsten PWM-Periodenanfang)
+    uint32_t irq = hal_irq_save();
+    if (!m->fault_latched)
+    {
+        deadtime_pio_step(m->current_step, step); // Sequenz anstoßen, kein Warten
+        m->current_step = (int8_t)step;
+    }
+    hal_irq_restore(irq);
+    perf_add(PERF_COMMUTATE, (int32_t)perf_cycles_since(start));
+}
+#else
+void commutate_step(motor_t *m, int step, uint16_t pwm_level)
+{
+    uint32_t start = hal_cycles();
+    const unsigned hs = (unsigned)COMMUTATION[step][0];
+    const unsigned ls = (unsigned)COMMUTATION[step][1];
+
+    // Fehler gespeichert -> Ausgänge sind schon aus, nichts schalten
+    if (m->fault_latched)
+    {
+        m->current_ls = -1; // Zustandsmerker zurücksetzen
+        return;             // verlasse Funktion ohne Umschalten
+    }
+
+    // 1) Deaktiviere aktuell aktive Low-Side (wenn vorhanden)
+    if (m->current_ls != -1)
+    {
+        ls_pwm_disable(m, (unsigned)m->current_ls); // Treiber aus
+        m->current_ls = -1;                         // Merker löschen
+    }
+    deadtime_delay_us(DEAD_TIME_US); // warte Deadtime nach LS-off
+
+    // 2) Alle HS in einem Zugriff: neuer HS ein, übrige aus
+    uint32_t irq = hal_irq_save();
+    if (!m->fault_latched)
+        hs_drive_mask(m, m->hs_mask[hs]);
+    hal_irq_restore(irq);
+    deadtime_delay_us(DEAD_TIME_US); // Deadtime, damit HS stabil leitet
+
+    // 3) Aktiviere die neue Low-Side PWM (N-MOSFET)
+    irq = hal_irq_save();
+    if (!m->fault_latched)
+    {
+        ls_pwm_enable(m, ls, pwm_level);
+        m->current_ls = (int8_t)ls;
+    }
+    hal_irq_restore(irq);
+    perf_add(PERF_COMMUTATE, (int32_t)perf_cycles_since(start));
+}
+#endif // BLDC_DEADTIME_PIO
+
+// -------------------- Sinus-Betrieb --------------------
+// Aufruf je PWM-Periode aus dem Wrap-Interrupt (sine.c): top = Phase, deren HS leitet,
+// level = LS-Duty je Phase (der Wert für top wird geschrieben, der LS bleibt aber aus).
+// Wechselt top, dient je eine PWM-Periode als Totzeit:
+//   Periode 1: LS der neuen oberen Phase aus
+//   Periode 2: alle HS in einem Zugriff umschalten (alter aus, neuer ein)
+//   Periode 3: LS der beiden anderen Phasen frei (auch der der bisherigen oberen Phase)
+// Ohne Busy-Wait, der Interrupt bleibt kurz. Fault-Prüfung wie in commutate_step.
+#if !BLDC_DEADTIME_PIO
+_Static_assert(DEAD_TIME_US * PWM_FREQ <= 1000000u, "Totzeit im Sinus-Betrieb ist eine PWM-Periode");
+
+void bldc_sine_apply(motor_t *m, uint8_t top, const uint16_t level[3])
+{
+    if (m->fault_latched)
+    {
+        m->sine_hs = 3; // Ausgänge sind schon aus
+        m->sine_stage = 0;
+        return;
+    }
+
+    for (unsigned i = 0; i < 3; ++i)
+        ls_pwm_set_level(m, i, level[i]); // nur CC, gilt ab der nächsten Periode
+
+    if (m->sine_stage == 0)
+    {
+        if (top == m->sine_hs)
+            return;
+        m->sine_next = top;
+        ls_pwm_disable(m, top);
+        m->sine_stage = 1;
+        return;
+    }
+
+    uint32_t irq = hal_irq_save();
+    if (!m->fault_latched)
+    {
+        if (m->sine_stage == 1)
+        {
+            hs_drive_mask(m, m->hs_mask[m->sine_next]);
+            m->sine_stage = 2;
+        }
+        else
+        {
+            for (unsigned i = 0; i < 3; ++i)
+                if (i != m->sine_next)
+                    hal_gpio_set_oeover(m->ls_pin[i], GPIO_OVERRIDE_NORMAL);
+            m->sine_hs = m->sine_next;
+            m->sine_stage = 0;
+        }
+    }
+    hal_irq_restore(irq);
+}
+#endif
+
+// -------------------- Init --------------------
+// Pins und Masken eines Motors aus MOTOR_PINS übernehmen, Leistungsstufe im Zustand "aus"
+static void motor_setup(motor_t *m, uint idx)
+{
+    m->hs_all_mask = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        m->hs_pin[i] = MOTOR_PIN_TABLE[idx].hs[i];
+        m->ls_pin[i] = MOTOR_PIN_TABLE[idx].ls[i];
+        m->ls_slice[i] = (uint8_t)SLICE_OF(m->ls_pin[i]);
+        m->ls_chan[i] = (uint8_t)CHAN_OF(m->ls_pin[i]);
+        m->hs_mask[i] = BIT(m->hs_pin[i]);
+        m->hs_all_mask |= m->hs_mask[i];
+        m->ls_level[i] = 0;
+        m->ls_req[i] = 0;
+    }
+    m->fault_pin = MOTOR_PIN_TABLE[idx].fault;
+    m->level_limit = PWM_WRAP;
+    m->fault_latched = false;
+    m->current_ls = -1;
+    m->current_step = -1;
+    m->sine_hs = 3;
+    m->sine_next = 3;
+    m->sine_stage = 0;
+}
+
+// Initialisiert Fault-/E-Stop-Eingänge, HS-Pins und PWM-Slices aller Motoren
+void bldc_init(void)
+{
+    // E-Stop Pin konfigurieren: Input mit Pull-Up (active LOW), gilt für alle Motoren
+    hal_gpio_init(ESTOP_PIN);
+    hal_gpio_set_dir(ESTOP_PIN, GPIO_IN);
+    hal_gpio_pull_up(ESTOP_PIN);
+
+    uint32_t ls_slice_mask = 0; // LS-Slices aller Motoren (starten synchron)
+    hs_all_motors_mask = 0;
+    fault_pins_mask = 0;
+    for (uint n = 0; n < MOTOR_COUNT; ++n)
+    {
+        motor_t *m = &motors[n];
+        motor_setup(m, n);
+        hs_all_motors_mask |= m->hs_all_mask;
+
+        // FAULT Pin konfigurieren: Input, hier Pull-Down angenommen (active HIGH)
+        if (m->fault_pin != MOTOR_NO_PIN)
+        {
+            hal_gpio_init(m->fault_pin);
+            hal_gpio_set_dir(m->fault_pin, GPIO_IN);
+            hal_gpio_pull_down(m->fault_pin);
+            fault_pins_mask |= BIT(m->fault_pin);
+        }
+
+        // HS Pins initial als Input (hochohmig) damit externe Pullups die HS off halten.
+        // gpio_init setzt Funktion SIO und Ausgangswert 0 – beides bleibt fest, geschaltet
+        // wird danach nur noch die Richtung (siehe hs_drive_mask).
+        for (int i = 0; i < 3; ++i)
+        {
+            hal_gpio_init(m->hs_pin[i]);
+            hal_gpio_set_dir(m->hs_pin[i], GPIO_IN); // hochohmig
+            hal_gpio_put(m->hs_pin[i], 0);           // Ausgangswert LOW, wirkt erst wenn Richtung = Ausgang
+            hal_gpio_disable_pulls(m->hs_pin[i]);    // keine internen Pulls verwenden (nutze externe 5V Pullups)
+        }
+
+#if BLDC_DEADTIME_PIO
+        // LS Pins bis zur Übergabe an die PIO ebenfalls hochohmig
+        for (int i = 0; i < 3; ++i)
+        {
+            hal_gpio_init(m->ls_pin[i]);
+            hal_gpio_set_dir(m->ls_pin[i], GPIO_IN);
+        }
+#else
+        // PWM Konfiguration für LS Pins: Treiber aus, bevor die PWM den Pin bekommt
+        for (int i = 0; i < 3; ++i)
+        {
+            hal_gpio_set_oeover(m->ls_pin[i], GPIO_OVERRIDE_LOW);
+            hal_gpio_set_function(m->ls_pin[i], GPIO_FUNC_PWM); // Funktion des Pins auf PWM setzen (bleibt so)
+            ls_slice_mask |= BIT(m->ls_slice[i]);
+        }
+#endif
+    }
+
+#if BLDC_DEADTIME_PIO
+    (void)ls_slice_mask;
+    deadtime_pio_init(DEAD_TIME_NS); // PIO übernimmt alle sechs Pins (Sequenz + LS-PWM)
+#else
+    // Teiler + Zählumfang ganzzahlig für PWM_FREQ; geht die Mindestauflösung nicht, dann
+    // wenigstens die Frequenz (Konfigurationsfehler, die Auflösung steht in der Startmeldung)
+    pwm_timing_t t;
+    if (!pwm_timing_calc(hal_clock_sys_hz(), PWM_FREQ, PWM_MIN_STEPS, PWM_PHASE_CORRECT, &t))
+        pwm_timing_calc(hal_clock_sys_hz(), PWM_FREQ, 2u, PWM_PHASE_CORRECT, &t);
+    // alle LS-Slices gleich eingestellt, gemeinsam gestartet; Phase C meldet den Wrap für
+    // Teilerwechsel (Phase A: Strommessung, Phase B: Sinus-Betrieb)
+    pwm_engine_init(ls_slice_mask, MAIN_MOTOR->ls_slice[2], &t);
+#endif
+}
+
+bool bldc_set_pwm_freq(uint32_t freq_hz)
+{
+#if BLDC_DEADTIME_PIO
+    (void)freq_hz;
+    return false; // PIO-PWM hat eine feste Periode (deadtime_pio.c)
+#else
+    return pwm_engine_set_freq(freq_hz, PWM_MIN_STEPS);
+#endif
+}
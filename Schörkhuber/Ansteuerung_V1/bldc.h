@@ -0,0 +1,74 @@
+// bldc.h
+// Leistungsstufe und 6-Step Kommutation (HS/LS schalten, Totzeit, Fault-Abfrage).
+// Jede Funktion schaltet die Brücke eines Motors (motor_t, siehe motor.h).
+// Alle Hardwarezugriffe gehen über hal.h, damit derselbe Code auch im
+// Host-Build (host/) gegen den Mock gelinkt werden kann.
+
+#ifndef BLDC_H
+#define BLDC_H
+
+#include "hal.h"
+#include "motor.h"
+
+// 6-Schritt Sequenz (trapezoidal) als X-Makro: X(HS_phase, LS_phase) je Schritt.
+// Daraus werden zur Compile-Zeit COMMUTATION und die PIO-Sequenztabellen erzeugt.
+#define COMMUTATION_SEQUENCE(X) \
+    X(0, 1)                     \
+    X(0, 2)                     \
+    X(1, 2)                     \
+    X(1, 0)                     \
+    X(2, 0)                     \
+    X(2, 1)
+
+// 6-Schritt Sequenz (trapezoidal). Jede Zeile {HS_phase, LS_phase}
+extern const int COMMUTATION[6][2];
+
+// motors[] aus MOTOR_PINS füllen; Fault-/E-Stop-Eingänge, HS-Pins und LS-PWM-Slices aller
+// Motoren initialisieren
+void bldc_init(void);
+
+// Schalte alle Ausgänge des Motors in sicheren Zustand (OFF)
+void all_off(motor_t *m);
+
+// true, wenn E-Stop oder der FAULT-Eingang des Motors aktiv ist (Pegel der Eingänge)
+bool is_fault_active(const motor_t *m);
+
+// Gespeicherter Fehler (Latch): gesetzt von bldc_emergency_off(), bleibt gesetzt, bis
+// bldc_fault_clear() ihn ausdrücklich löscht. Solange er gesetzt ist, schaltet commutate_step nichts ein.
+bool bldc_fault_latched(const motor_t *m);
+
+// Not-Abschaltung (aus dem Fault-Interrupt): Latch setzen, alle HS mit einem Schreibzugriff aus,
+// danach die LS-Treiber
+void bldc_emergency_off(motor_t *m);
+
+// wie bldc_emergency_off, aber für alle Motoren (E-Stop): die HS aller Motoren in einem Zugriff
+void bldc_emergency_off_all(void);
+
+// Latch löschen, wenn E-Stop/FAULT nicht mehr aktiv sind; true = gelöscht
+bool bldc_fault_clear(motor_t *m);
+
+// SIO-Bits der FAULT-Eingänge aller Motoren (nach bldc_init)
+uint32_t bldc_fault_pins_mask(void);
+
+// Eine Kommutationsstufe sicher ausführen (step 0..5, pwm_level 0..PWM_WRAP)
+void commutate_step(motor_t *m, int step, uint16_t pwm_level);
+
+// Duty (0..PWM_WRAP) sofort übernehmen, ohne die Schaltstellung zu ändern
+void bldc_set_level(motor_t *m, uint16_t pwm_level);
+
+// Obergrenze für den Duty aller Phasen (Strombegrenzung, current.c); PWM_WRAP = keine Grenze.
+// Angeforderte Werte bleiben gespeichert und gelten wieder, sobald die Grenze steigt.
+void bldc_set_level_limit(motor_t *m, uint16_t limit);
+
+// größter gerade ins CC-Register geschriebene Duty (nach der Begrenzung)
+uint16_t bldc_level_applied(const motor_t *m);
+
+// Sinus-Betrieb (sine.c), je PWM-Periode: HS der Phase top ein, LS der anderen beiden mit
+// level[] (0..PWM_WRAP). Nicht im PIO-Betrieb.
+void bldc_sine_apply(motor_t *m, uint8_t top, const uint16_t level[3]);
+
+// PWM-Frequenz der Low-Sides aller Motoren im Betrieb ändern (ab dem nächsten Wrap, Duty bleibt in %).
+// false, wenn die Frequenz mit PWM_MIN_STEPS nicht erreichbar ist (oder im PIO-Betrieb).
+bool bldc_set_pwm_freq(uint32_t freq_hz);
+
+#endif // BLDC_H
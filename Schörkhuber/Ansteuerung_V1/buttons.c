@@ -0,0 +1,121 @@
+// buttons.c
+// Taster-Entprellung und Auto-Repeat im Interrupt (aus main.c herausgelöst).
+// Vorher las die Hauptschleife alle POLL_MS Zeit und Pegel beider Taster. Jetzt:
+//  - Flanke (Bank-0-Interrupt): Entprelltermin = jetzt + BUTTON_DEBOUNCE_MS, jede weitere
+//    Prellflanke schiebt ihn nach hinten
+//  - Alarm BUTTON_ALARM_NUM zum frühesten Termin: Pegel lesen; neu gedrückt -> Ereignis und
+//    Repeat-Termin in BUTTON_REPEAT_MS, weiter gedrückt -> Repeat-Ereignis, losgelassen -> Ruhe
+// Ohne Tastendruck läuft weder Alarm noch Interrupt. Beide Interrupts haben dieselbe Priorität
+// und unterbrechen sich deshalb nicht gegenseitig; Ereignisse erzeugt nur der Alarm (ein Erzeuger).
+
+#include "buttons.h"
+#include "config.h"
+#include "spsc.h"
+
+#define BUTTON_MASK ((1u << BUTTON_INC_PIN) | (1u << BUTTON_DEC_PIN))
+
+static btn_t btn[2];
+SPSC_DEFINE(btn_ring, uint8_t, 8); // Alarm-Interrupt -> Hauptschleife
+static volatile uint32_t btn_dropped;
+
+static void post(const btn_t *b)
+{
+    if (!spsc_push(&btn_ring, &b->evt))
+        btn_dropped++;
+}
+
+// Alarm auf den frühesten laufenden Termin stellen (oder entschärfen)
+static void btn_arm(uint32_t now)
+{
+    bool any = false;
+    uint32_t at = 0;
+    for (int i = 0; i < 2; ++i)
+        if (btn[i].timer && (!any || (int32_t)(btn[i].due_us - at) < 0))
+        {
+            at = btn[i].due_us;
+            any = true;
+        }
+    if (!any)
+    {
+        hal_alarm_disarm(BUTTON_ALARM_NUM);
+        return;
+    }
+    if ((int32_t)(at - now) < (int32_t)COMM_MIN_LEAD_US)
+        at = now + COMM_MIN_LEAD_US; // Termin schon vorbei -> gleich auslösen
+    hal_alarm_arm(BUTTON_ALARM_NUM, at);
+}
+
+// Bank-0-Interrupt: Flanke an einem Taster -> Entprellzeit (neu) starten
+static void button_edge_isr(void)
+{
+    uint32_t pending = hal_gpio_irq_status(BUTTON_MASK);
+    if (!pending)
+        return; // Interrupt gilt einem anderen Modul (Fault, Hall)
+    hal_gpio_irq_ack(pending);
+
+    uint32_t now = hal_time_us_32();
+    for (int i = 0; i < 2; ++i)
+        if (pending & (1u << btn[i].pin))
+        {
+            btn[i].timer = true;
+            btn[i].due_us = now + BUTTON_DEBOUNCE_MS * 1000u;
+        }
+    btn_arm(now);
+}
+
+// Alarm: Entprellzeit bzw. Repeat-Intervall abgelaufen
+static void button_alarm_isr(void)
+{
+    hal_alarm_ack(BUTTON_ALARM_NUM);
+    uint32_t now = hal_time_us_32();
+    for (int i = 0; i < 2; ++i)
+    {
+        btn_t *b = &btn[i];
+        if (!b->timer || (int32_t)(now - b->due_us) < 0)
+            continue;
+
+        bool pressed = !hal_gpio_get(b->pin); // active LOW
+        b->timer = pressed;                   // solange gedrückt: Repeat-Termin
+        if (pressed)
+        {
+            // neu gedrückt oder weiter gehalten: Ereignis, nächster Repeat fest im Raster
+            b->due_us = b->pressed ? b->due_us + BUTTON_REPEAT_MS * 1000u : now + BUTTON_REPEAT_MS * 1000u;
+            post(b);
+        }
+        b->pressed = pressed; // losgelassen -> kein Ereignis
+    }
+    btn_arm(now);
+}
+
+// Initialisierung der Tasterpins, des Flanken-Interrupts und des Alarms
+void buttons_init(void)
+{
+    btn[0] = (btn_t){BUTTON_INC_PIN, BTN_EVT_INC, false, false, 0};
+    btn[1] = (btn_t){BUTTON_DEC_PIN, BTN_EVT_DEC, false, false, 0};
+
+    // GPIO Konfiguration: Input mit Pull-Up, da active LOW Taster
+    for (int i = 0; i < 2; ++i)
+    {
+        hal_gpio_init(btn[i].pin);             // Pin initialisieren
+        hal_gpio_set_dir(btn[i].pin, GPIO_IN); // als Input
+        hal_gpio_pull_up(btn[i].pin);          // internen Pullup aktivieren (Pin = 1 wenn offen)
+    }
+
+    hal_alarm_init(BUTTON_ALARM_NUM, button_alarm_isr, BUTTON_IRQ_PRIORITY);
+    hal_gpio_irq_init(BUTTON_MASK, button_edge_isr, BUTTON_IRQ_ORDER); // beide Flanken
+    hal_gpio_irq_set_priority(BUTTON_IRQ_PRIORITY);                    // gilt nur für diesen Kern
+}
+
+bool button_event_pop(btn_evt_t *evt)
+{
+    uint8_t e;
+    if (!spsc_pop(&btn_ring, &e))
+        return false;
+    *evt = (btn_evt_t)e;
+    return true;
+}
+
+uint32_t button_events_dropped(void)
+{
+    return btn_dropped;
+}
@@ -0,0 +1,37 @@
+// buttons.h
+// Taster "schneller"/"langsamer" mit Entprellung und Auto-Repeat, komplett im Interrupt:
+// eine Flanke am Tasterpin startet die Entprellzeit, ein One-Shot-Hardware-Alarm prüft danach
+// den Pegel und erzeugt Druck- bzw. Repeat-Ereignisse. Die Ereignisse landen in einem kleinen
+// SPSC-Ring; die Hauptschleife holt sie mit button_event_pop() ab und kann dazwischen schlafen.
+
+#ifndef BUTTONS_H
+#define BUTTONS_H
+
+#include "hal.h"
+
+typedef enum
+{
+    BTN_EVT_INC, // Taster "schneller" gedrückt oder Repeat
+    BTN_EVT_DEC, // Taster "langsamer" gedrückt oder Repeat
+} btn_evt_t;
+
+// Zustand eines Tasters (nur in den Interrupts verändert)
+typedef struct
+{
+    uint pin;        // GPIO Pin Nummer
+    uint8_t evt;     // btn_evt_t, das der Taster erzeugt
+    bool pressed;    // zuletzt stabil gemessener Zustand (true = gedrückt)
+    bool timer;      // Entprell- oder Repeat-Termin läuft
+    uint32_t due_us; // Termin (timerawl), an dem der Alarm den Pegel prüft
+} btn_t;
+
+// Pins, Flanken-Interrupt und Alarm BUTTON_ALARM_NUM auf dem aufrufenden Kern einrichten
+void buttons_init(void);
+
+// nächstes Taster-Ereignis holen; false, wenn keines ansteht
+bool button_event_pop(btn_evt_t *evt);
+
+// Ereignisse, die wegen vollem Ring verworfen wurden
+uint32_t button_events_dropped(void);
+
+#endif // BUTTONS_H
@@ -0,0 +1,363 @@
+// comm_sched.c
+// Kommutations-Scheduler (Hardware-Alarm)
+// Statt im main() per sleep_ms zu warten, programmiert der Scheduler den Hardware-Alarm
+// COMM_ALARM_NUM auf den absoluten Zeitpunkt (µs) des nächsten Schritts. Der Interrupt
+// führt commutate_step() aus und plant sofort den Folgetermin. Da die Termine absolut
+// (deadline += step_time_us) berechnet werden, summieren sich Verzögerungen nicht auf.
+//
+// Mehrere Motoren: jeder Motor hat seinen eigenen nächsten Termin (next_at), der Alarm steht
+// immer auf dem frühesten. Der Interrupt bedient alle Motoren, deren Termin erreicht ist (oder
+// näher als COMM_MIN_LEAD_US liegt), und programmiert danach den nächsten frühesten. Ein
+// Schritt mit Software-Totzeit blockiert 2 * DEAD_TIME_US; ein gleichzeitig fälliger Schritt
+// eines anderen Motors kommt entsprechend später (steht in der Jitter-Statistik).
+//
+// Sensorless (nur MAIN_MOTOR): Nach der Kommutation wird eine Ausblendzeit (1/4 Schritt,
+// Abklingen des Freilaufstroms) abgewartet, dann fragt derselbe Alarm alle BEMF_POLL_US den
+// Nulldurchgang der offenen Phase ab. Der nächste Schritt folgt 30° el. = halbe Schrittdauer
+// danach. Bleibt der Nulldurchgang aus, wird nach 2 Schrittdauern trotzdem kommutiert; nach
+// BEMF_LOST_STEPS solchen Schritten in Folge geht es zurück in den Open-Loop, zuerst ab der
+// gemessenen Schrittdauer, erst wenn auch das nicht greift mit Ausrichten ab RAMP_START_US.
+//
+// Hall (nur MAIN_MOTOR): Der Flanken-Interrupt (hall.c) nimmt nur Zeitstempel und Schritt auf und
+// stößt diesen Interrupt per NVIC an (hal_alarm_pend); geschaltet wird hier mit COMM_IRQ_PRIORITY.
+// So läuft im Bank-0-Interrupt, den sich Hall und Fault teilen, nie ein Schritt mit Totzeit, und
+// die Schritte aller Motoren gehen durch denselben Handler. Jitter = Flanke bis Schalten.
+//
+// Open-Loop: Die Schrittdauer folgt der Ziel-Schrittdauer step_target_us über die Rampe (ramp.c),
+// je Schritt ein ramp_next(). Ein Start aus dem Stand hält zuerst einen Schritt RAMP_ALIGN_MS lang
+// mit RAMP_ALIGN_LEVEL (Rotor ausrichten) und beginnt die Rampe dann bei RAMP_START_US.
+
+#include "comm_sched.h"
+#include "bemf.h"
+#include "bldc.h"
+#include "config.h"
+#include "perf.h"
+#include "telemetry.h"
+
+static comm_jitter_t comm_jitter;                // wird im ISR beschrieben (alle Motoren)
+static volatile bool sensorless_enabled = false; // Übergabe an Sensorless erlaubt? (MAIN_MOTOR)
+
+static void comm_jitter_reset(comm_jitter_t *j)
+{
+    j->count = 0;
+    j->min_us = INT32_MAX;
+    j->max_us = INT32_MIN;
+    j->sum_us = 0;
+    j->missed = 0;
+}
+
+// Abweichung eines Schritts vom Soll-Zeitpunkt in die Statistik (Interrupt)
+static void comm_jitter_add(motor_t *m, int32_t jitter)
+{
+    comm_jitter.count++;
+    comm_jitter.sum_us += (uint32_t)(jitter < 0 ? -jitter : jitter);
+    if (jitter < comm_jitter.min_us)
+        comm_jitter.min_us = jitter;
+    if (jitter > comm_jitter.max_us)
+        comm_jitter.max_us = jitter;
+    // tatsächlicher minus geplanter Schrittabstand = Änderung der Abweichung seit dem letzten Schritt
+    if (m->jitter_valid)
+        perf_add(PERF_INTERVAL, jitter - m->last_jitter);
+    m->last_jitter = jitter;
+    m->jitter_valid = true;
+}
+
+// Nächsten Kommutationstermin des Motors setzen; liegt er zu knapp/vorbei, wird er auf
+// "jetzt + Vorlauf" verschoben. Den Alarm programmiert erst comm_rearm (frühester aller Motoren).
+static void comm_arm(motor_t *m, uint32_t deadline)
+{
+    uint32_t now = hal_time_us_32();
+    if ((int32_t)(deadline - now) < (int32_t)COMM_MIN_LEAD_US)
+    {
+        deadline = now + COMM_MIN_LEAD_US;
+        comm_jitter.missed++;
+    }
+    m->deadline = deadline;
+    m->next_at = deadline;
+}
+
+// Erste Schrittdauer der Rampe aus dem Stand: RAMP_START_US, ist das Ziel langsamer, gleich das Ziel
+static uint32_t ramp_start_us(const motor_t *m)
+{
+    uint32_t target = m->step_target_us;
+    return target > RAMP_START_US ? target : RAMP_START_US;
+}
+
+// Termin für die nächste ZC-Abfrage (kein Kommutationstermin, zählt nicht als verpasst)
+static void comm_arm_poll(motor_t *m, uint32_t at)
+{
+    m->next_at = at;
+}
+
+// Alarm auf den frühesten Termin aller laufenden Motoren; keiner läuft -> Alarm aus.
+// Aufruf im Alarm-Interrupt oder mit gesperrten Interrupts.
+static void comm_rearm(void)
+{
+    uint32_t now = hal_time_us_32();
+    bool any = false;
+    int32_t first = 0;
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+    {
+        const motor_t *m = &motors[i];
+        int32_t d = (int32_t)(m->next_at - now);
+        if (m->running && m->mode != COMM_HALL && (!any || d < first))
+        {
+            first = d;
+            any = true;
+        }
+    }
+    if (!any)
+    {
+        hal_alarm_disarm(COMM_ALARM_NUM);
+        return;
+    }
+    if (first < (int32_t)COMM_MIN_LEAD_US)
+        first = (int32_t)COMM_MIN_LEAD_US; // Hardware-Vergleich würde sonst erst nach ~71 min treffen
+    hal_alarm_arm(COMM_ALARM_NUM, now + (uint32_t)first);
+}
+
+// ZC-Abfrage im Sensorless-Betrieb (Aufruf aus dem Alarm-Interrupt)
+static void comm_poll(motor_t *m, uint32_t now)
+{
+    if (bemf_zero_crossed())
+    {
+        // Schrittdauer = Abstand zweier Nulldurchgänge, leicht gefiltert (3/4 alt + 1/4 neu)
+        m->period = (3 * m->period + (now - m->last_zc)) / 4;
+        m->last_zc = now;
+        m->lost = 0;
+        m->resync = false; // Wiederanlauf hat gegriffen
+        m->step_time_us = m->period;
+        m->polling = false;
+        comm_arm(m, now + m->period / 2); // 30° el. nach dem Nulldurchgang kommutieren
+        return;
+    }
+
+    if (now - m->last_step < 2 * m->period)
+    {
+        comm_arm_poll(m, now + BEMF_POLL_US);
+        return;
+    }
+
+    // kein Nulldurchgang: Schritt erzwingen, Nulldurchgang dort annehmen, wo er hätte sein sollen
+    m->last_zc = m->last_step + m->period / 2;
+    m->polling = false;
+    if (++m->lost >= BEMF_LOST_STEPS)
+    {
+        // Synchronisation verloren (Laststoß) -> Open-Loop ab der zuletzt gemessenen Schrittdauer,
+        // der Rotor dreht noch etwa so schnell; die Rampe führt von dort zum alten Ziel und übergibt
+        // wieder. Ging schon dieser Wiederanlauf verloren (Rotor blockiert), neu ausrichten und ab
+        // RAMP_START_US anlaufen wie aus dem Stand.
+        m->mode = COMM_OPEN_LOOP;
+        if (!m->resync && m->period < RAMP_START_US)
+        {
+            m->resync = true;
+            m->step_time_us = m->period;
+        }
+        else
+        {
+            m->resync = false;
+            m->aligning = RAMP_ALIGN_MS > 0;
+            m->step_time_us = ramp_start_us(m);
+        }
+        ramp_reset(&m->ramp, m->step_time_us);
+    }
+    comm_arm(m, now);
+}
+
+// Hall-Betrieb: den von hall.c gemeldeten Schritt schalten (Aufruf aus dem Alarm-Interrupt)
+static void comm_hall(motor_t *m, uint32_t now)
+{
+    uint32_t irq = hal_irq_save(); // Flanken-Interrupt könnte zwischen Lesen und Löschen melden
+    int step = m->hall_step;
+    uint32_t edge = m->hall_edge_us;
+    m->hall_step = -1;
+    hal_irq_restore(irq);
+    if (step < 0)
+        return;
+
+    comm_jitter_add(m, (int32_t)(now - edge)); // Flanke bis Schalten
+    commutate_step(m, step, m->pwm_level);
+    telemetry_record(edge, (uint8_t)step, m->pwm_level, TELEM_FLAG_HALL);
+    m->step = (uint8_t)((step + 1) % 6);
+}
+
+// Fälligen Termin eines Motors bearbeiten: Kommutation oder ZC-Abfrage
+static void comm_service(motor_t *m, uint32_t now)
+{
+    if (m->polling)
+    {
+        comm_poll(m, now);
+        return;
+    }
+
+    // Jitter = tatsächlicher Zeitpunkt minus geplanter Termin
+    comm_jitter_add(m, (int32_t)(now - m->deadline));
+
+    int done = m->step;
+    uint16_t level = m->pwm_level;
+    if (m->aligning && level > RAMP_ALIGN_LEVEL)
+        level = RAMP_ALIGN_LEVEL;
+    commutate_step(m, done, level);
+    if (m == MAIN_MOTOR)
+        telemetry_record(now, (uint8_t)done, level, m->mode == COMM_SENSORLESS ? TELEM_FLAG_SENSORLESS : 0);
+    m->step = (uint8_t)((done + 1) % 6); // nächster Schritt (zyklisch 0..5)
+
+    if (m->aligning)
+    {
+        // Ausrichten: Schritt halten, danach beginnt die Rampe (nächster Schritt wieder mit pwm_level)
+        m->aligning = false;
+        comm_arm(m, m->deadline + RAMP_ALIGN_MS * 1000u);
+        return;
+    }
+
+    // Anlauframpe schnell genug -> Sensorless übernehmen, Startwert = aktuelle Schrittdauer
+    if (m == MAIN_MOTOR && m->mode == COMM_OPEN_LOOP && sensorless_enabled && m->step_time_us <= BEMF_HANDOVER_US)
+    {
+        m->mode = COMM_SENSORLESS;
+        m->period = m->step_time_us;
+        m->last_zc = m->deadline - m->step_time_us / 2;
+        m->lost = 0;
+    }
+
+    if (m->mode == COMM_SENSORLESS)
+    {
+        m->last_step = m->deadline;
+        bemf_begin_step(done);
+        m->polling = true;
+        comm_arm_poll(m, m->deadline + m->period / 4); // Ausblendzeit 15° el.
+        return;
+    }
+
+    m->step_time_us = ramp_next(&m->ramp, m->step_target_us); // Dauer dieses Schritts aus der Rampe
+    comm_arm(m, m->deadline + m->step_time_us);               // Folgetermin relativ zum geplanten, nicht zum tatsächlichen Zeitpunkt
+}
+
+// Interrupt-Handler des Kommutations-Alarms
+void comm_alarm_isr(void)
+{
+    uint32_t now = hal_time_us_32(); // so früh wie möglich Zeit nehmen
+    hal_alarm_ack(COMM_ALARM_NUM);   // Interrupt quittieren
+
+    // Jeder Motor höchstens einmal je Durchlauf; nach einem Schritt mit Totzeit ist Zeit
+    // vergangen, deshalb vor jedem Motor neu lesen
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+    {
+        motor_t *m = &motors[i];
+        if (i > 0)
+            now = hal_time_us_32();
+        if (!m->running)
+            continue;
+        if (m->mode == COMM_HALL)
+            comm_hall(m, now); // angestoßen von hall.c, kein Termin
+        else if ((int32_t)(m->next_at - now) < (int32_t)COMM_MIN_LEAD_US)
+            comm_service(m, now);
+    }
+    comm_rearm();
+}
+
+void comm_scheduler_init(void)
+{
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+    {
+        motors[i].step_time_us = STEP_TIME_INIT_US;
+        motors[i].step_target_us = STEP_TIME_INIT_US;
+        motors[i].mode = COMM_OPEN_LOOP;
+        motors[i].running = false;
+    }
+    hal_alarm_init(COMM_ALARM_NUM, comm_alarm_isr, COMM_IRQ_PRIORITY);
+    comm_jitter_reset(&comm_jitter);
+}
+
+static void comm_start(motor_t *m, uint16_t pwm_level, uint32_t step_us, bool align)
+{
+    uint32_t irq = hal_irq_save(); // Alarm-Interrupt darf die Termine nicht halb sehen
+    m->pwm_level = pwm_level;
+    m->mode = COMM_OPEN_LOOP; // jeder Start beginnt mit dem Open-Loop-Anlauf
+    m->polling = false;
+    m->aligning = align && RAMP_ALIGN_MS > 0;
+    m->resync = false;
+    m->jitter_valid = false;
+    m->step_time_us = step_us;
+    ramp_reset(&m->ramp, step_us);
+    m->running = true;
+    comm_arm(m, hal_time_us_32() + 2 * COMM_MIN_LEAD_US);
+    comm_rearm();
+    hal_irq_restore(irq);
+}
+
+void comm_scheduler_start(motor_t *m, uint16_t pwm_level)
+{
+    comm_start(m, pwm_level, ramp_start_us(m), true);
+}
+
+void comm_scheduler_resume(motor_t *m, uint16_t pwm_level)
+{
+    comm_start(m, pwm_level, m->step_time_us, false);
+}
+
+void comm_scheduler_start_hall(motor_t *m, uint16_t pwm_level)
+{
+    uint32_t irq = hal_irq_save();
+    m->pwm_level = pwm_level;
+    m->mode = COMM_HALL;
+    m->polling = false;
+    m->aligning = false;
+    m->jitter_valid = false;
+    m->hall_step = -1;
+    m->running = true;
+    comm_rearm(); // Termine der übrigen Motoren, dieser hat keinen
+    hal_irq_restore(irq);
+}
+
+void comm_scheduler_hall_edge(motor_t *m, int step, uint32_t edge_us)
+{
+    m->hall_edge_us = edge_us;
+    m->hall_step = (int8_t)step;
+    hal_alarm_pend(COMM_ALARM_NUM); // schaltet, sobald der Flanken-Interrupt zurückkehrt
+}
+
+void comm_scheduler_stop(motor_t *m)
+{
+    uint32_t irq = hal_irq_save();
+    m->running = false;
+    comm_rearm(); // übrige Motoren laufen weiter
+    hal_irq_restore(irq);
+}
+
+void comm_scheduler_set_level(motor_t *m, uint16_t pwm_level)
+{
+    m->pwm_level = pwm_level;
+}
+
+void comm_scheduler_enable_sensorless(bool enable)
+{
+    sensorless_enabled = enable;
+    if (!enable && MAIN_MOTOR->mode == COMM_SENSORLESS)
+        MAIN_MOTOR->mode = COMM_OPEN_LOOP; // ab dem nächsten Schritt wieder feste Schrittdauer
+}
+
+comm_mode_t comm_scheduler_mode(const motor_t *m)
+{
+    return m->mode;
+}
+
+int comm_scheduler_step(const motor_t *m)
+{
+    return (m->step + 5) % 6; // m->step ist der nächste
+}
+
+uint32_t comm_scheduler_rpm(const motor_t *m)
+{
+    uint32_t t = m->step_time_us; // eine 32-bit Lesung, vom Interrupt atomar geschrieben
+    // 1 Umdrehung = 6 Schritte je Polpaar
+    return t ? 60000000u / (6u * MOTOR_POLE_PAIRS * t) : 0;
+}
+
+// Interrupt kurz sperren, damit die Kopie konsistent ist
+void comm_jitter_take(comm_jitter_t *out)
+{
+    hal_alarm_irq_set_enabled(COMM_ALARM_NUM, false);
+    *out = comm_jitter;
+    comm_jitter_reset(&comm_jitter);
+    hal_alarm_irq_set_enabled(COMM_ALARM_NUM, true);
+}
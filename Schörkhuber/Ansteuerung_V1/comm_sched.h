@@ -0,0 +1,71 @@
+// comm_sched.h
+// Kommutations-Scheduler: führt commutate_step() im Interrupt eines Hardware-Alarms
+// zu absoluten µs-Terminen aus und misst dabei den Jitter.
+// Betriebsarten: Open-Loop (Rampe auf step_target_us), Sensorless (Termine aus dem
+// Gegen-EMK-Nulldurchgang, siehe bemf.h) und Hall (Schritt aus der Flanke, siehe hall.h).
+// Open-Loop dient als Anlauf und Rückfallebene.
+// Ein Alarm kommutiert alle Motoren (motors[], siehe motor.h), jeden mit eigener
+// Schrittdauer m->step_time_us; Sensorless nur MAIN_MOTOR.
+
+#ifndef COMM_SCHED_H
+#define COMM_SCHED_H
+
+#include "hal.h"
+#include "motor.h"
+
+// Jitter-Statistik: Abweichung tatsächlicher Zeitpunkt (ISR-Eintritt) vs. geplanter Termin
+typedef struct
+{
+    uint32_t count;  // Anzahl gemessener Schritte
+    int32_t min_us;  // kleinste Abweichung
+    int32_t max_us;  // größte Abweichung
+    uint64_t sum_us; // Summe der Abweichungen (für Mittelwert)
+    uint32_t missed; // Termine, die bereits vorbei waren (Schritt verspätet nachgeholt)
+} comm_jitter_t;
+
+// Einmalige Einrichtung: Alarm reservieren, Handler mit COMM_IRQ_PRIORITY (direkt unter dem Fault-Interrupt) registrieren
+void comm_scheduler_init(void);
+
+// Kommutation eines Motors aus dem Stand starten: erster Schritt sofort (nach Mindestvorlauf) und
+// RAMP_ALIGN_MS gehalten, dann Rampe ab RAMP_START_US bis m->step_target_us.
+// Aufruf auf dem Kern des Alarm-Interrupts (core1).
+void comm_scheduler_start(motor_t *m, uint16_t pwm_level);
+
+// Wie comm_scheduler_start, aber für einen drehenden Rotor (Wechsel vom Sinus-Betrieb): ohne
+// Ausrichten, die Rampe beginnt bei der aktuellen m->step_time_us
+void comm_scheduler_resume(motor_t *m, uint16_t pwm_level);
+
+// Hall-Betrieb starten: kein eigener Termin, geschaltet wird jeder mit comm_scheduler_hall_edge
+// gemeldete Schritt. Aufruf auf dem Kern des Alarm-Interrupts (core1).
+void comm_scheduler_start_hall(motor_t *m, uint16_t pwm_level);
+
+// Aus dem Hall-Flanken-Interrupt: Schritt und Zeitstempel vormerken und den Alarm-Interrupt
+// anstoßen (hal_alarm_pend). Geschaltet wird dort mit COMM_IRQ_PRIORITY, nicht im GPIO-Interrupt.
+void comm_scheduler_hall_edge(motor_t *m, int step, uint32_t edge_us);
+
+// Kommutation eines Motors anhalten, die übrigen laufen weiter. Ausgänge schaltet der Aufrufer ab.
+void comm_scheduler_stop(motor_t *m);
+
+// Duty ändern, mit dem der Interrupt kommutiert (wirkt ab dem nächsten Schritt)
+void comm_scheduler_set_level(motor_t *m, uint16_t pwm_level);
+
+// Sensorless-Betrieb von MAIN_MOTOR erlauben: Übergabe, sobald step_time_us <= BEMF_HANDOVER_US.
+// bemf_init() muss vorher aufgerufen worden sein.
+void comm_scheduler_enable_sensorless(bool enable);
+
+// aktuelle Betriebsart
+comm_mode_t comm_scheduler_mode(const motor_t *m);
+
+// zuletzt geschalteter Schritt 0..5
+int comm_scheduler_step(const motor_t *m);
+
+// Drehzahl in U/min aus der aktuellen Schrittdauer (im Sensorless-Betrieb gemessen)
+uint32_t comm_scheduler_rpm(const motor_t *m);
+
+// Kopie der Jitter-Statistik (alle Motoren) holen und zurücksetzen
+void comm_jitter_take(comm_jitter_t *out);
+
+// Interrupt-Handler des Alarms (im Host-Build ruft der Mock ihn auf)
+void comm_alarm_isr(void);
+
+#endif // COMM_SCHED_H
@@ -0,0 +1,204 @@
+// config.h
+// Zentrale Konfiguration der BLDC-Ansteuerung (Pins, PWM, Timing).
+// Alle Module (bldc.c, buttons.c, comm_sched.c, main.c) und der Host-Build
+// (host/) verwenden diese Werte, deshalb stehen sie als Makros hier und nicht
+// mehr als const-Variablen in main.c.
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+// -------------------- Konfiguration (anpassen!) --------------------
+// Hier definierst du die verwendeten Pins und grundlegende Parameter.
+// Erkläre in der Arbeit: Warum diese Pins, welche Hardware hängt daran, Spannungspegel, etc.
+
+// HS_PIN: Gate-Pins für die High-Side P‑MOSFETs (Phase A,B,C)
+// In deinem Hardwareaufbau: MCU zieht Gate auf GND => P‑MOSFET schaltet ein.
+// Wenn Pin hochohmig (Input) => externer Pullup zieht Gate auf 5V => P‑MOSFET aus.
+#define HS_PIN_A 2u
+#define HS_PIN_B 6u
+#define HS_PIN_C 10u
+
+// LS_PIN: PWM-Pins für die Low-Side N‑MOSFETs (Phase A,B,C)
+// Hier läuft später die PWM (Funktion GPIO_FUNC_PWM)
+#define LS_PIN_A 3u
+#define LS_PIN_B 7u
+#define LS_PIN_C 11u
+
+// Buttons: Increase / Decrease (active LOW angenommen, deshalb Pull‑Up)
+#define BUTTON_INC_PIN 12u // Taster schneller
+#define BUTTON_DEC_PIN 13u // Taster langsamer
+
+// Not-Aus / Fault Pins (hardwareseitig verbinden)
+// ESTOP: active LOW → gedrückt = 0 = E‑Stop aktiv
+#define ESTOP_PIN 14u
+// FAULT: optionaler Fehler-Eingang (z. B. Überstromdetektor), hier active HIGH
+#define FAULT_PIN 15u
+// Flanken an ESTOP/FAULT lösen einen Interrupt mit höchster Priorität aus (fault.c),
+// der alle Ausgänge abschaltet und den Fehler speichert (Latch)
+#define FAULT_IRQ_PRIORITY 0x00u // NVIC: unterbricht auch die Kommutation (gilt für Bank 0: dort schaltet sonst niemand)
+#define FAULT_IRQ_ORDER 0xffu    // innerhalb von Bank 0 vor allen anderen GPIO-Handlern
+#define FAULT_RESTART_MS 50u     // so lange muss der Fehler weg sein, bevor neu gestartet wird
+#define FAULT_SELFTEST_RUNS 16u  // Latenz-Selbsttest beim Start (erzwungene Interrupts)
+
+// Mehrere Motoren an einem RP2040 (siehe motor.h). Motor 0 sind die Pins oben (Hauptantrieb mit
+// Hall, Gegen-EMK, Sinus-Betrieb, Strommessung), weitere Motoren laufen im Open-Loop über
+// denselben Kommutations-Scheduler. Je Motor X(HS A,B,C, LS A,B,C, FAULT-Pin), verwendet werden
+// die ersten MOTOR_COUNT Zeilen. LS-Pins verschiedener Motoren dürfen sich keinen PWM-Kanal
+// (Slice + A/B) teilen; alle LS-Slices laufen mit derselben Frequenz.
+// Beispiel Motor 1: LS 5/8/22 = Slice 2B/4A/3A, HS 9/20/21, FAULT 19 (GPIO 0/1 = stdio-UART)
+#ifndef MOTOR_COUNT
+#define MOTOR_COUNT 1u
+#endif
+#define MOTOR_NO_PIN 0xffu // Motor ohne eigenen FAULT-Eingang (nur E-Stop)
+#define MOTOR_PINS(X)                                                        \
+    X(HS_PIN_A, HS_PIN_B, HS_PIN_C, LS_PIN_A, LS_PIN_B, LS_PIN_C, FAULT_PIN) \
+    X(9u, 20u, 21u, 5u, 8u, 22u, 19u)
+
+// PWM Basis-Einstellungen (Berechnung von Teiler und Zählumfang in pwm_engine.c):
+// PWM_FREQ: gewünschte PWM-Frequenz (20 kHz ist üblich für Motorsteuerungen)
+#define PWM_FREQ 20000u // 20 kHz
+// PWM_WRAP: Skala aller Duty-Werte im Programm (0..PWM_WRAP = 0..100 %), unabhängig vom
+// tatsächlichen Zählumfang der Hardware (bei 20 kHz mittenzentriert: 3125 Stufen)
+#define PWM_WRAP 65535u // (2^16 - 1)
+// PWM_PHASE_CORRECT: 1 = mittenzentriert (auf/ab zählen), Einschaltzeit symmetrisch zur Periode
+#define PWM_PHASE_CORRECT 1
+// PWM_MIN_STEPS: geforderte Mindestauflösung (Duty-Stufen); bei 125 MHz und 20 kHz sind mittenzentriert
+// höchstens 3125 Stufen möglich, mehr nur mit niedrigerer Frequenz
+#define PWM_MIN_STEPS 1024u
+// Teilerwechsel im Betrieb (pwm_engine.c): im gemeinsamen PWM-Interrupt vor Strombegrenzung und Sinus
+#define PWM_ENGINE_IRQ_ORDER 0xc0u
+
+// DEAD_TIME_US: softwarebasierte Totzeit in Mikrosekunden, um Shoot‑Through zu vermeiden.
+// Hinweise: Software-Deadtime ist ungenauer als hardwareseitige Deadtime. Sie muss an Gate‑Lade‑/Entladezeiten angepasst werden.
+#define DEAD_TIME_US 10u // microseconds (anpassen/vermessen!)
+
+// BLDC_DEADTIME_PIO: 1 = Schaltsequenz inkl. Totzeit läuft in PIO0 (deadtime_pio.c, bldc_seq.pio),
+// taktgenau in 8 ns Schritten und ohne CPU-Wartezeit. Die Brückenpins gehören dann der PIO,
+// die LS-PWM kommt ebenfalls aus der PIO. Wird über die CMake-Option BLDC_DEADTIME_PIO gesetzt.
+#ifndef BLDC_DEADTIME_PIO
+#define BLDC_DEADTIME_PIO 0
+#endif
+// DEAD_TIME_NS: Totzeit im PIO-Betrieb (an Gate-Ladung der MOSFETs anpassen/vermessen!).
+// Nur zur Compile-Zeit: zur Laufzeit läuft SM0 durchgehend, ein Umladen würde laufende Sequenzen stören.
+#define DEAD_TIME_NS 800u
+
+// Kommutations-Timing: steuert die Drehzahl im Open‑Loop (siehe comm_sched.c).
+// step_time_us = Dauer einer Kommutationsstufe in Mikrosekunden; kleiner -> schneller.
+#define STEP_TIME_INIT_US 200000u // initiale Ziel-Schrittdauer 200 ms
+#define STEP_TIME_MIN_US 500u     // minimaler Wert (schnell, 0,5 ms)
+#define STEP_TIME_MAX_US 2000000u // maximaler Wert (sehr langsam, 2 s)
+// Schrittweite pro Tastendruck: 1/8 der aktuellen Schrittdauer (bei kurzen Schrittzeiten feiner),
+// mindestens STEP_TIME_STEP_MIN_US
+#define STEP_TIME_STEP_DIV 8u
+#define STEP_TIME_STEP_MIN_US 10u
+// Anlauf/Drehzahländerung im Open-Loop über eine Rampe (ramp.c) statt in Sprüngen: der Scheduler
+// verkürzt bzw. verlängert die Schrittdauer Schritt für Schritt Richtung Ziel-Schrittdauer.
+// Vor dem Anlauf aus dem Stand wird der erste Schritt RAMP_ALIGN_MS lang mit reduziertem Duty
+// gehalten, damit der Rotor an einer bekannten Stelle steht.
+#define RAMP_ALIGN_MS 100u               // Ausrichtzeit (0 = ohne Ausrichten)
+#define RAMP_ALIGN_LEVEL (PWM_WRAP / 4u) // Duty beim Ausrichten (höchstens pwm_level)
+#define RAMP_START_US 20000u             // erste Schrittdauer der Rampe aus dem Stand
+#define RAMP_ACCEL 1000u                 // Beschleunigung in Schritte/s² (1000 = 2500 U/min pro s bei 4 Polpaaren)
+#define RAMP_JERK 0u                     // Ruck in Schritte/s³; 0 = konstante Beschleunigung, sonst S-Kurve
+
+// Button Debounce / Auto-Repeat Zeiten
+#define BUTTON_DEBOUNCE_MS 50u // Entprellzeit
+#define BUTTON_REPEAT_MS 150u  // Wiederholintervall beim Halten
+// Entprellung/Repeat per One-Shot-Alarm und Flanken-Interrupt auf core0 (siehe buttons.c)
+#define BUTTON_ALARM_NUM 2        // Alarm 0/1: Kommutation/Regler, 3: SDK (sleep_ms, Timer)
+#define BUTTON_IRQ_PRIORITY 0x80u // Alarm und Bank 0 auf core0 gleich -> keine gegenseitige Unterbrechung
+#define BUTTON_IRQ_ORDER 0x40u    // im gemeinsamen Bank-0-Interrupt nach Fault und Hall
+
+// Weckintervall der Hauptschleife auf core0 (Log-Ausgabe, Telemetrie); dazwischen schläft sie
+// in __wfi(). Taster wecken per Interrupt sofort, die Kommutation läuft ohnehin auf core1.
+#define POLL_MS 10u
+
+// Hardware-Alarm für den Kommutations-Scheduler (Alarm 3 nutzt das SDK selbst für sleep_ms)
+#define COMM_ALARM_NUM 0
+// Mindestvorlauf beim Neuprogrammieren des Alarms: liegt der nächste Termin schon
+// (fast) in der Vergangenheit, würde der 32-bit-Vergleich erst nach ~71 min wieder treffen
+#define COMM_MIN_LEAD_US 5u
+// NVIC-Priorität (0x00 = höchste, 0xc0 = niedrigste): Kommutation direkt unter dem Fault-Interrupt
+#define COMM_IRQ_PRIORITY 0x40u
+
+// Sensorless (Gegen-EMK, siehe bemf.c): Phasenspannungen über Spannungsteiler an den ADC-Eingängen.
+// Phase A,B,C = ADC0..2 = GPIO 26..28; der ADC tastet frei laufend reihum ab, DMA schreibt mit.
+#define BEMF_ADC_INPUTS 3u
+// Abfrageintervall des Nulldurchgangs nach der Ausblendzeit (Auflösung der ZC-Zeitmessung)
+#define BEMF_POLL_US 20u
+// Hysterese um den virtuellen Sternpunkt in ADC-Counts (12 bit), gegen Rauschen/PWM-Spitzen
+#define BEMF_ZC_HYST 8u
+// Übergabe Open-Loop -> Sensorless, sobald die Anlauframpe diese Schrittdauer erreicht
+// (darunter ist die Gegen-EMK groß genug für eine sichere Erkennung)
+#define BEMF_HANDOVER_US 5000u
+// so viele Schritte in Folge ohne Nulldurchgang -> zurück in den Open-Loop-Anlauf
+#define BEMF_LOST_STEPS 3u
+
+// Hall-Sensoren (optional, siehe hall.c): Open-Collector-Ausgänge, interne Pull-Ups.
+// Ohne angeschlossene Sensoren lesen alle drei Pins 1 (ungültiger Code 7) -> kein Hall-Betrieb.
+#define HALL_PIN_A 16u
+#define HALL_PIN_B 17u
+#define HALL_PIN_C 18u
+// Hall-Code (A | B<<1 | C<<2) je Kommutationsschritt 0..5, Reihenfolge wie COMMUTATION.
+// Hängt von Sensor-Einbaulage und Verdrahtung ab -> am Motor ausmessen (Welle von Hand drehen)!
+#define HALL_SEQUENCE {5, 1, 3, 2, 6, 4}
+// Polpaarzahl des Motors (nur für die Drehzahlanzeige in U/min)
+#define MOTOR_POLE_PAIRS 4u
+// keine Hall-Flanke innerhalb dieser Zeit -> Drehzahl gilt als 0 (Stillstand)
+#define HALL_TIMEOUT_US 500000u
+// Aufrufreihenfolge des Hall-Handlers im gemeinsamen Bank-0-Interrupt (nach Fault). Er läuft damit
+// mit FAULT_IRQ_PRIORITY und meldet den Schritt nur; geschaltet wird im Kommutations-Alarm.
+#define HALL_IRQ_ORDER 0x80u
+
+// Drehzahlregler (PI, Festkomma, siehe speed_ctrl.c) im Hall- und Sensorless-Betrieb
+#define SPEED_ALARM_NUM 1               // eigener Hardware-Alarm für den festen Regeltakt
+#define SPEED_IRQ_PRIORITY 0x80u        // unter der Kommutation, darf von ihr unterbrochen werden
+#define SPEED_CTRL_PERIOD_US 1000u      // Regeltakt 1 kHz
+#define SPEED_KP_Q16 (8u << 16)         // Kp = 8 Duty-Counts pro U/min (Q16.16)
+#define SPEED_KI_Q16 (1u << 15)         // Ki = 0,5 Duty-Counts pro U/min und Regeltakt (Q16.16)
+#define SPEED_DUTY_MIN (PWM_WRAP / 16u) // untere Grenze: Gegen-EMK bleibt messbar, Motor zieht noch
+#define SPEED_DUTY_MAX PWM_WRAP         // obere Grenze
+#define SPEED_TARGET_INIT_RPM 1000u     // Solldrehzahl nach der Übergabe an den Regler
+#define SPEED_TARGET_STEP_RPM 100u      // Änderung pro Tastendruck
+#define SPEED_TARGET_MAX_RPM 10000u     // größte einstellbare Solldrehzahl
+
+// Trajektorie (siehe traj.c): zeitgesteuerte Sollwerte, ausgeführt im Regeltakt (Auflösung
+// SPEED_CTRL_PERIOD_US). Ring 2^n Punkte à 12 Byte, core0 schiebt nach, während er abläuft.
+#define TRAJ_POINTS 256u
+
+// Strommessung (siehe current.c): Shunt-Verstärker am ADC-Eingang 3 (GPIO 29), wird im
+// Round-Robin der Gegen-EMK mitgewandelt. Auf dem Pico-Board misst ADC3 VSYS/3 -> nur mit
+// eigener Platine einschalten, über die CMake-Option BLDC_CURRENT_SENSE.
+#ifndef CURRENT_SENSE
+#define CURRENT_SENSE 0
+#endif
+#define CURRENT_ADC_INPUT 3u // muss direkt nach den Gegen-EMK-Eingängen liegen
+// Grenze in ADC-Counts (12 bit, 3,3 V). Beispiel: 10 mOhm Shunt, Verstärkung 20
+// -> 0,2 V/A = 248 Counts/A; 2480 Counts = 10 A
+#define CURRENT_LIMIT_ADC 2480u
+#define CURRENT_RING_BITS 7u                    // DMA-Ring 2^7 Byte = 64 Messwerte (eine pro PWM-Periode)
+#define CURRENT_IRQ_PRIORITY 0x40u              // wie die Kommutation, direkt unter dem Fault-Interrupt
+#define CURRENT_IRQ_ORDER 0x80u                 // im gemeinsamen PWM-Interrupt vor dem Sinus-Betrieb
+#define CURRENT_CUT_SHIFT 3u                    // Überstrom: Duty-Grenze um 1/8 unter den aktuellen Duty
+#define CURRENT_RECOVER_STEP (PWM_WRAP / 2048u) // je Periode ohne Überstrom (ganz frei nach ~100 ms)
+// so alt ist der Messwert am Wrap höchstens: eine Round-Robin-Runde (4 Eingänge * 2 µs) plus die
+// Wandlung selbst. Bei kürzerem halbem LS-Puls wird nicht begrenzt (current.c).
+#define CURRENT_SAMPLE_AGE_US 10u
+
+// Sinus-Betrieb (siehe sine.c), zur Laufzeit statt 6-Step wählbar (CTRL_CMD_SET_DRIVE_MODE)
+#define SINE_ADVANCE_DEG 0u      // Voreilwinkel el. beim Start (Grad), CTRL_CMD_SET_ADVANCE
+#define SINE_ADVANCE_MAX_DEG 60u // größter einstellbarer Voreilwinkel
+#define SINE_IRQ_ORDER 0x40u     // im gemeinsamen PWM-Interrupt nach der Strombegrenzung
+
+// Binär-Telemetrie (siehe telemetry.c): eigener UART-Ausgang, damit stdio auf uart0 frei bleibt.
+// uart1 TX liegt auf GPIO 4 (nicht von der Leistungsstufe belegt); nur Senden, kein RX-Pin.
+#define TELEM_UART_TX_PIN 4u
+#define TELEM_BAUD 921600u       // 92 kByte/s, reicht für jeden Schritt bis ~7000 Schritte/s
+#define TELEM_RING_SIZE 1024u    // Messpunkte im Ring (2^n), 12 KByte
+#define TELEM_FRAME_SAMPLES 64u  // Messpunkte je Rahmen (~8 ms auf der Leitung, < POLL_MS)
+#define TELEM_DECIM_MAX_SHIFT 7u // höchste Dezimierung: jeder 128. Schritt
+
+// Wie oft die Jitter-Statistik ausgegeben wird
+#define JITTER_REPORT_MS 2000u
+
+#endif // CONFIG_H
@@ -0,0 +1,519 @@
+// control.c
+// Kontrollschleife auf core1 (aus main.c herausgelöst).
+// Hier laufen alle Teile, deren Timing zählt: Leistungsstufe/Totzeit (bldc.c), Kommutation
+// (comm_sched.c, hall.c bzw. sine.c), Gegen-EMK (bemf.c), Drehzahlregler (speed_ctrl.c),
+// zeitgesteuerte Sollwerte (traj.c), Strombegrenzung (current.c) und die Fault-Behandlung (fault.c). Die Interrupts dieser Module
+// werden in control_init() registriert und damit im NVIC von core1 freigegeben; core0 sieht sie nie.
+//
+// Austausch mit core0 nur über SPSC-Ringe (spsc.h): Befehle kommen über cmd_ring, Meldungen gehen
+// als DLOG() (Formatstring + rohe Argumente, dlog.h) hinaus und werden erst auf core0 formatiert.
+// core1 wartet nie auf core0: ist der Log-Ring voll, wird die Meldung verworfen und gezählt.
+//
+// Weitere Motoren (MOTOR_COUNT > 1, motor.h) laufen im Open-Loop über denselben Scheduler mit
+// eigener Schrittdauer; Befehle an sie tragen die Motornummer (control_send_motor).
+
+#include "control.h"
+#include "bemf.h"
+#include "bldc.h"
+#include "comm_sched.h"
+#include "config.h"
+#include "current.h"
+#include "dlog.h"
+#include "fault.h"
+#include "hall.h"
+#include "perf.h"
+#include "pwm_engine.h"
+#include "ramp.h"
+#include "sine.h"
+#include "spsc.h"
+#include "speed_ctrl.h"
+#include "traj.h"
+
+SPSC_DEFINE(cmd_ring, ctrl_cmd_t, 16); // core0 -> core1
+
+// -------------------- Betriebsart --------------------
+// Hall-Sensoren angeschlossen -> Hall-Kommutation, sonst Open-Loop-Anlauf + Sensorless
+static bool use_hall = false;
+static bool sine_mode = false;              // Sinus-Betrieb statt 6-Step (CTRL_CMD_SET_DRIVE_MODE)
+static volatile uint16_t pwm_level;         // Duty im gesteuerten Betrieb (Open-Loop-Anlauf), auch aus traj_apply
+static comm_mode_t last_mode;               // zuletzt gemeldete Betriebsart
+static bool faulted[MOTOR_COUNT];           // Fault gemeldet, Motor gestoppt
+static uint32_t fault_seen_at[MOTOR_COUNT]; // letzter Zeitpunkt (ms), an dem der Fault noch anlag
+static uint32_t last_report;                // letzte periodische Telemetrie (ms)
+static uint32_t traj_reported;              // zuletzt gemeldete Zahl ausgeführter Trajektorienpunkte
+static uint32_t sine_ramp_at;               // Sinus-Betrieb: Ende des laufenden Rampenschritts (µs)
+
+// Antrieb starten; flying = Rotor dreht schon (Wechsel 6-Step <-> Sinus), dann ohne Ausrichten
+// und mit der aktuellen Schrittdauer weiter
+static void drive_start(uint16_t level, bool flying)
+{
+    if (sine_mode)
+    {
+        int step = use_hall ? hall_step() : comm_scheduler_step(MAIN_MOTOR);
+        sine_start(level, step < 0 ? 0 : step); // Winkel ab der Lage des letzten Schritts
+    }
+    else if (use_hall)
+    {
+        hall_start(level);        // Rotor gibt den Takt vor
+        speed_ctrl_enable(level); // Hall liefert ab dem Start eine Drehzahl -> sofort regeln
+    }
+    else if (flying)
+        comm_scheduler_resume(MAIN_MOTOR, level);
+    else
+        comm_scheduler_start(MAIN_MOTOR, level); // Alarm-Interrupt kommutiert
+}
+
+static void drive_stop(void)
+{
+    speed_ctrl_disable();
+    hall_stop();
+    comm_scheduler_stop(MAIN_MOTOR);
+    sine_stop();
+}
+
+// Duty übernehmen: sofort in die Leistungsstufe und für die folgenden Kommutationen
+// (Aufruf auch aus dem Drehzahlregler-Interrupt)
+static void drive_set_level(uint16_t level)
+{
+    if (sine_mode)
+    {
+        sine_set_level(level); // Duty je Phase rechnet der Sinus-Interrupt
+        return;
+    }
+    if (use_hall)
+        hall_set_level(level);
+    else
+        comm_scheduler_set_level(MAIN_MOTOR, level);
+    bldc_set_level(MAIN_MOTOR, level);
+}
+
+// Istdrehzahl für den Regler: Hall-Flanken bzw. Gegen-EMK-Schrittdauer
+static uint32_t drive_rpm(void)
+{
+    return use_hall ? hall_rpm() : comm_scheduler_rpm(MAIN_MOTOR);
+}
+
+// Motor anhalten bzw. nach einem Fault neu starten; Hauptantrieb über drive_*, weitere Motoren
+// nur über den Scheduler (Open-Loop mit der zuletzt eingestellten Schrittdauer)
+static void motor_stop(motor_t *m)
+{
+    if (m == MAIN_MOTOR)
+        drive_stop();
+    else
+        comm_scheduler_stop(m);
+}
+
+static void motor_start(motor_t *m)
+{
+    all_off(m); // nochmals sicherstellen
+    if (m == MAIN_MOTOR)
+    {
+        drive_set_level(pwm_level);
+        last_mode = COMM_OPEN_LOOP;
+        drive_start(pwm_level, false);
+    }
+    else
+    {
+        bldc_set_level(m, pwm_level);
+        comm_scheduler_start(m, pwm_level);
+    }
+}
+
+// Not-Aus / Fault eines Motors: abgeschaltet hat schon der Interrupt (fault.c). Hier wird der
+// Motor gestoppt, gemeldet und nach FAULT_RESTART_MS ohne Fehler das Latch gelöscht und neu
+// gestartet. Pegelprüfung als Rückfallebene, falls eine Flanke verloren ging.
+// Rückgabe: true, solange der Motor wegen des Faults steht.
+static bool poll_fault(uint i, uint32_t now)
+{
+    motor_t *m = &motors[i];
+    if (!bldc_fault_latched(m) && is_fault_active(m))
+        bldc_emergency_off(m);
+    if (bldc_fault_latched(m))
+    {
+        if (!faulted[i])
+        {
+            motor_stop(m);
+            faulted[i] = true;
+            fault_stats_t fs;
+            fault_get_stats(&fs);
+            if (i == 0)
+            {
+                traj_stop(traj_pushed()); // kein Sollwert aus dem alten Profil nach dem Wiederanlauf
+                DLOG("Fault/EStop active -> all off (reaction %u.%03u us, max %u.%03u us, #%u)\n",
+                     fs.last_ns / 1000, fs.last_ns % 1000, fs.max_ns / 1000, fs.max_ns % 1000, fs.count);
+            }
+            else
+                DLOG("Motor %u: Fault/EStop active -> off (#%u)\n", i, fs.count);
+        }
+        if (is_fault_active(m))
+            fault_seen_at[i] = now;
+        // erst nach FAULT_RESTART_MS fehlerfreiem Zustand Latch löschen (Stabilisierung), ohne zu blockieren
+        if (now - fault_seen_at[i] < FAULT_RESTART_MS || !bldc_fault_clear(m))
+            return true;
+    }
+    if (faulted[i])
+    {
+        faulted[i] = false;
+        if (i == 0)
+            DLOG("Fault cleared. Resuming.\n");
+        else
+            DLOG("Motor %u: Fault cleared. Resuming.\n", i);
+        motor_start(m);
+    }
+    return false;
+}
+
+// -------------------- Trajektorie --------------------
+// Open-Loop-Schrittdauer für eine Drehzahl (1 Umdrehung = 6 Schritte je Polpaar), begrenzt
+static uint32_t step_time_of_rpm(uint32_t rpm)
+{
+    uint32_t t = rpm ? 10000000u / (MOTOR_POLE_PAIRS * rpm) : STEP_TIME_MAX_US;
+    if (t < STEP_TIME_MIN_US)
+        return STEP_TIME_MIN_US;
+    return t > STEP_TIME_MAX_US ? STEP_TIME_MAX_US : t;
+}
+
+// Fälligen Punkt ausführen (Aufruf im Regler-Interrupt, vor dem Regelschritt desselben Takts)
+static void traj_apply(const traj_point_t *p)
+{
+    switch (p->kind)
+    {
+    case TRAJ_SPEED:
+        if (speed_ctrl_enabled())
+            speed_ctrl_set_target(p->value < SPEED_TARGET_MAX_RPM ? p->value : SPEED_TARGET_MAX_RPM);
+        else
+            MAIN_MOTOR->step_target_us = step_time_of_rpm(p->value); // Open-Loop: Rampe dorthin
+        break;
+    case TRAJ_DUTY:
+        if (p->value <= PWM_WRAP && !speed_ctrl_enabled())
+        {
+            pwm_level = (uint16_t)p->value;
+            drive_set_level(pwm_level);
+        }
+        break;
+    case TRAJ_STEP_TIME:
+        if (p->value >= STEP_TIME_MIN_US && p->value <= STEP_TIME_MAX_US)
+            MAIN_MOTOR->step_target_us = p->value;
+        break;
+    }
+}
+
+// -------------------- Befehle von core0 --------------------
+// Ziel-Schrittdauer eines Motors um 1/STEP_TIME_STEP_DIV (mind. STEP_TIME_STEP_MIN_US)
+// verkürzen bzw. verlängern, begrenzt auf STEP_TIME_MIN_US..STEP_TIME_MAX_US. Dorthin fährt die
+// Rampe (Scheduler bzw. sine_ramp), die Schrittdauer springt also nicht.
+static uint32_t change_step_time(motor_t *m, bool faster)
+{
+    uint32_t t = m->step_target_us;
+    uint32_t delta = t / STEP_TIME_STEP_DIV;
+    if (delta < STEP_TIME_STEP_MIN_US)
+        delta = STEP_TIME_STEP_MIN_US;
+    if (faster)
+        t = t > STEP_TIME_MIN_US + delta ? t - delta : STEP_TIME_MIN_US; // kürzere Schritte
+    else
+        t = t + delta < STEP_TIME_MAX_US ? t + delta : STEP_TIME_MAX_US; // längere Schritte
+    m->step_target_us = t;
+    return t;
+}
+
+static void change_speed(bool faster)
+{
+    if (speed_ctrl_enabled())
+    {
+        // Drehzahlregelung: Solldrehzahl verstellen, den Duty stellt der Regler
+        uint32_t target = speed_ctrl_target();
+        if (faster)
+            target = target + SPEED_TARGET_STEP_RPM < SPEED_TARGET_MAX_RPM ? target + SPEED_TARGET_STEP_RPM : SPEED_TARGET_MAX_RPM;
+        else
+            target = target > SPEED_TARGET_STEP_RPM ? target - SPEED_TARGET_STEP_RPM : 0;
+        speed_ctrl_set_target(target);
+        DLOG(faster ? "Speed UP -> target=%u rpm\n" : "Speed DOWN -> target=%u rpm\n", target);
+        return;
+    }
+
+    // Open-Loop: Ziel-Schrittdauer anpassen (der ISR rampt ab dem nächsten Schritt dorthin)
+    uint32_t t = change_step_time(MAIN_MOTOR, faster);
+    DLOG(faster ? "Speed UP -> step_target_us=%u\n" : "Speed DOWN -> step_target_us=%u\n", t);
+}
+
+// 6-Step <-> Sinus im Lauf: Antrieb anhalten, Ausgänge aus, im neuen Verfahren an derselben
+// Rotorlage und mit derselben Drehzahl (step_time_us) weiter. Im Sensorless-Betrieb steht dort
+// die gemessene Schrittdauer, mit Hall-Sensoren wird sie aus dem letzten Sektor übernommen.
+static void set_drive_mode(bool sine)
+{
+    if (sine == sine_mode)
+        return;
+#if BLDC_DEADTIME_PIO
+    if (sine)
+    {
+        DLOG("Drive mode: sine not available with PIO dead time\n");
+        return;
+    }
+#endif
+    drive_stop();
+    all_off(MAIN_MOTOR);
+    if (sine && use_hall)
+    {
+        hall_speed_t hs;
+        hall_get_speed(&hs);
+        if (hs.period_us >= STEP_TIME_MIN_US && hs.period_us <= STEP_TIME_MAX_US)
+            MAIN_MOTOR->step_time_us = MAIN_MOTOR->step_target_us = hs.period_us;
+    }
+    sine_mode = sine;
+    sine_set_step_time(MAIN_MOTOR->step_time_us);
+    ramp_reset(&MAIN_MOTOR->ramp, MAIN_MOTOR->step_time_us); // Rampe im Sinus-Betrieb ab der aktuellen Drehzahl
+    sine_ramp_at = hal_time_us_32();
+    last_mode = COMM_OPEN_LOOP; // 6-Step beginnt wieder mit dem Open-Loop-Anlauf
+    drive_set_level(pwm_level);
+    drive_start(pwm_level, true);
+    DLOG(sine ? "Drive mode: sine (step_time_us=%u)\n" : "Drive mode: 6-step (step_time_us=%u)\n", MAIN_MOTOR->step_time_us);
+}
+
+// Sinus-Betrieb: ohne Kommutations-Interrupt läuft die Rampe hier, je fälligem Schritt ein
+// ramp_next(); die neue Schrittdauer übernimmt der Sinus-Interrupt ab der nächsten PWM-Periode
+static void sine_ramp(void)
+{
+    motor_t *m = MAIN_MOTOR;
+    uint32_t now = hal_time_us_32();
+    if (!ramp_running(&m->ramp, m->step_target_us))
+    {
+        sine_ramp_at = now;
+        if (m->step_time_us != m->step_target_us)
+        {
+            m->step_time_us = m->step_target_us;
+            sine_set_step_time(m->step_time_us);
+        }
+        return;
+    }
+    if ((int32_t)(now - sine_ramp_at) < 0)
+        return;
+    while ((int32_t)(now - sine_ramp_at) >= 0 && ramp_running(&m->ramp, m->step_target_us))
+    {
+        m->step_time_us = ramp_next(&m->ramp, m->step_target_us);
+        sine_ramp_at += m->step_time_us;
+    }
+    sine_set_step_time(m->step_time_us);
+}
+
+static void log_pwm_timing(void)
+{
+    const pwm_timing_t *t = pwm_engine_timing();
+    DLOG(t->phase_correct ? "PWM: %u.%03u Hz center-aligned, %u steps, div %u+%u/16\n"
+                          : "PWM: %u.%03u Hz edge-aligned, %u steps, div %u+%u/16\n",
+         t->freq_mhz / 1000, t->freq_mhz % 1000, t->top + 1u, t->div_int, t->div_frac);
+}
+
+// Befehl an einen weiteren Motor: nur die Open-Loop-Schrittdauer ist einstellbar
+static void handle_aux_cmd(const ctrl_cmd_t *c)
+{
+    if (c->motor >= MOTOR_COUNT)
+    {
+        DLOG("Motor %u: not configured (MOTOR_COUNT=%u)\n", c->motor, MOTOR_COUNT);
+        return;
+    }
+    motor_t *m = &motors[c->motor];
+    switch (c->type)
+    {
+    case CTRL_CMD_FASTER:
+    case CTRL_CMD_SLOWER:
+        DLOG(c->type == CTRL_CMD_FASTER ? "Motor %u: Speed UP -> step_target_us=%u\n" : "Motor %u: Speed DOWN -> step_target_us=%u\n",
+             c->motor, change_step_time(m, c->type == CTRL_CMD_FASTER));
+        break;
+    case CTRL_CMD_SET_STEP_TIME:
+        if (c->value >= STEP_TIME_MIN_US && c->value <= STEP_TIME_MAX_US)
+            m->step_target_us = c->value;
+        DLOG("Motor %u: Speed SET -> step_target_us=%u\n", c->motor, m->step_target_us);
+        break;
+    default:
+        DLOG("Motor %u: command %u only for motor 0\n", c->motor, c->type);
+        break;
+    }
+}
+
+static void handle_cmd(const ctrl_cmd_t *c)
+{
+    if (c->motor != 0)
+    {
+        handle_aux_cmd(c);
+        return;
+    }
+    switch (c->type)
+    {
+    case CTRL_CMD_FASTER:
+        change_speed(true);
+        break;
+    case CTRL_CMD_SLOWER:
+        change_speed(false);
+        break;
+    case CTRL_CMD_SET_STEP_TIME:
+        if (c->value >= STEP_TIME_MIN_US && c->value <= STEP_TIME_MAX_US && !speed_ctrl_enabled())
+            MAIN_MOTOR->step_target_us = c->value;
+        DLOG("Speed SET -> step_target_us=%u\n", MAIN_MOTOR->step_target_us);
+        break;
+    case CTRL_CMD_SET_TARGET:
+        speed_ctrl_set_target(c->value < SPEED_TARGET_MAX_RPM ? c->value : SPEED_TARGET_MAX_RPM);
+        DLOG("Speed SET -> target=%u rpm\n", speed_ctrl_target());
+        break;
+    case CTRL_CMD_SET_PWM_FREQ:
+        if (bldc_set_pwm_freq(c->value))
+        {
+            sine_set_step_time(MAIN_MOTOR->step_time_us); // Winkel je Periode hängt an der PWM-Frequenz
+            log_pwm_timing();
+        }
+        else
+            DLOG("PWM %u Hz not possible with %u steps\n", c->value, PWM_MIN_STEPS);
+        break;
+    case CTRL_CMD_SET_DRIVE_MODE:
+        set_drive_mode(c->value != 0);
+        break;
+    case CTRL_CMD_SET_ADVANCE:
+        sine_set_advance(c->value);
+        DLOG("Sine SET -> advance=%u deg\n", sine_advance());
+        break;
+    case CTRL_CMD_TRAJ_START:
+        traj_start();
+        DLOG("Trajectory start\n");
+        break;
+    case CTRL_CMD_TRAJ_STOP:
+        traj_stop(c->value);
+        DLOG("Trajectory stop\n");
+        break;
+    }
+}
+
+// -------------------- core1 --------------------
+void control_init(void)
+{
+    bldc_init();    // Motor-Instanzen, Fault-Eingänge, HS-Pins, LS-PWM
+    fault_init();   // E-Stop/FAULT-Interrupt (höchste Priorität)
+    bemf_init();    // ADC + DMA für die Gegen-EMK starten
+    hall_init();    // Hall-Pins + Flanken-Interrupt
+    current_init(); // Strommessung am PWM-Wrap + Begrenzung (nur mit CURRENT_SENSE)
+    sine_init();    // Sinus-Betrieb am PWM-Wrap (startet erst mit CTRL_CMD_SET_DRIVE_MODE)
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+        all_off(&motors[i]); // alle Ausgänge in sicheren Zustand setzen
+    comm_scheduler_init();
+    comm_scheduler_enable_sensorless(true); // nach dem Anlauf auf Gegen-EMK umschalten
+    use_hall = hall_present();
+    traj_init(traj_apply);
+    speed_ctrl_init(drive_rpm, drive_set_level, traj_tick);
+
+    // pwm_level = 80% DutyCycle initial; hier als Wert im Bereich 0..PWM_WRAP
+    pwm_level = (uint32_t)PWM_WRAP * 80 / 100;
+    last_mode = COMM_OPEN_LOOP;
+    last_report = hal_time_ms();
+
+    DLOG(use_hall ? "BLDC driver (buttons) started. mode=hall step_time_us=%u\n"
+                  : "BLDC driver (buttons) started. mode=open-loop step_time_us=%u\n",
+         MAIN_MOTOR->step_time_us);
+    if (MOTOR_COUNT > 1)
+        DLOG("Motors: %u (1..%u open-loop)\n", MOTOR_COUNT, MOTOR_COUNT - 1);
+
+#if !BLDC_DEADTIME_PIO
+    log_pwm_timing();
+#endif
+
+    // Reaktionszeit der Not-Abschaltung messen, solange der Motor noch steht
+    uint32_t min_ns, max_ns;
+    fault_selftest(FAULT_SELFTEST_RUNS, &min_ns, &max_ns);
+    DLOG("Fault reaction self-test: edge -> outputs off %u.%03u .. %u.%03u us (%u runs)\n",
+         min_ns / 1000, min_ns % 1000, max_ns / 1000, max_ns % 1000, FAULT_SELFTEST_RUNS);
+
+    drive_start(pwm_level, false);
+    for (uint i = 1; i < MOTOR_COUNT; ++i)
+    {
+        bldc_set_level(&motors[i], pwm_level);
+        comm_scheduler_start(&motors[i], pwm_level);
+    }
+}
+
+void control_poll(void)
+{
+    uint32_t now = hal_time_ms();
+    perf_poll(); // STATS-Anforderungen von core0, auch während eines Faults
+
+    // Not-Aus / Fault je Motor. Befehle für die übrigen Motoren laufen weiter; solange der
+    // Hauptantrieb steht, werden seine Fahrbefehle verworfen (nur TRAJ_STOP wirkt, er schaltet nichts ein)
+    bool main_held = false;
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+        if (poll_fault(i, now) && i == 0)
+            main_held = true;
+
+    ctrl_cmd_t c;
+    while (spsc_pop(&cmd_ring, &c))
+    {
+        if (main_held && c.motor == 0 && c.type != CTRL_CMD_TRAJ_STOP)
+            DLOG("Fault: command %u for motor 0 dropped\n", c.type);
+        else
+            handle_cmd(&c);
+    }
+    if (main_held)
+        return;
+    if (sine_mode)
+        sine_ramp();
+
+    // Betriebsartwechsel (Übergabe nach dem Anlauf bzw. Rückfall bei Sync-Verlust):
+    // im Sensorless-Betrieb übernimmt der Drehzahlregler den Duty, im Open-Loop wieder der feste Wert
+    comm_mode_t mode = comm_scheduler_mode(MAIN_MOTOR);
+    if (!use_hall && !sine_mode && mode != last_mode)
+    {
+        last_mode = mode;
+        if (mode == COMM_SENSORLESS)
+        {
+            speed_ctrl_set_target(comm_scheduler_rpm(MAIN_MOTOR)); // Solldrehzahl = erreichte Drehzahl
+            speed_ctrl_enable(pwm_level);
+            DLOG("Sensorless active (step_time_us=%u) -> speed control, target=%u rpm\n", MAIN_MOTOR->step_time_us, speed_ctrl_target());
+        }
+        else
+        {
+            speed_ctrl_disable();
+            drive_set_level(pwm_level);
+            DLOG("BEMF lost -> open-loop restart (step_time_us=%u)\n", MAIN_MOTOR->step_time_us);
+        }
+    }
+
+    // Jitter-/Drehzahl-Meldungen periodisch an core0
+    if (now - last_report >= JITTER_REPORT_MS)
+    {
+        last_report = now;
+        comm_jitter_t j;
+        comm_jitter_take(&j);
+        // Mittelwert der Beträge, 64-bit-Summe schon hier teilen (DLOG übergibt nur 32 bit)
+        uint32_t avg_us = j.count ? (uint32_t)(j.sum_us / j.count) : 0u;
+        if (j.count > 0)
+            DLOG("Jitter: n=%u min=%d us max=%d us avg=%u us missed=%u\n",
+                 j.count, j.min_us, j.max_us, avg_us, j.missed);
+        if (speed_ctrl_enabled())
+            DLOG("Speed: target=%u rpm actual=%u rpm duty=%u\n", speed_ctrl_target(), drive_rpm(), speed_ctrl_level());
+        traj_stats_t ts;
+        traj_get_stats(&ts);
+        if (ts.queued || ts.done != traj_reported)
+        {
+            traj_reported = ts.done;
+            DLOG("Trajectory: done=%u queued=%u late=%u max_late=%u us\n", ts.done, ts.queued, ts.late, ts.max_late_us);
+        }
+#if CURRENT_SENSE
+        current_stats_t cs;
+        current_get_stats(&cs);
+        DLOG("Current: last=%u peak=%u limit=%u trips=%u/%u\n", cs.last, cs.peak, cs.limit, cs.trips, cs.samples);
+#endif
+        if (use_hall)
+        {
+            hall_speed_t hs;
+            hall_get_speed(&hs);
+            DLOG("Hall: rpm=%u sector=%u us edges=%u invalid=%u\n", hall_rpm(), hs.period_us, hs.edges, hs.invalid);
+        }
+    }
+}
+
+// -------------------- core0 --------------------
+bool control_send(ctrl_cmd_type_t type, uint32_t value)
+{
+    return control_send_motor(0, type, value);
+}
+
+bool control_send_motor(uint motor, ctrl_cmd_type_t type, uint32_t value)
+{
+    ctrl_cmd_t c = {(uint8_t)type, (uint8_t)motor, value};
+    return spsc_push(&cmd_ring, &c);
+}
@@ -0,0 +1,46 @@
+// control.h
+// Echtzeitteil der Ansteuerung, läuft allein auf core1: Leistungsstufe, Kommutation
+// (Alarm-/Hall-Interrupts), Drehzahlregler und Fault-Behandlung. core0 (main.c) macht
+// nur stdio und Taster und spricht mit core1 ausschließlich über SPSC-Ringe (Befehle hier,
+// Meldungen über dlog.h). Da core1 nie printf aufruft, kann eine volle UART keinen
+// Kommutationsschritt verzögern.
+
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include "hal.h"
+
+// Befehle core0 -> core1
+typedef enum
+{
+    CTRL_CMD_FASTER,         // Taster schneller: Open-Loop kürzere Schrittdauer, geregelt höhere Solldrehzahl
+    CTRL_CMD_SLOWER,         // Taster langsamer
+    CTRL_CMD_SET_STEP_TIME,  // value = Schrittdauer in µs (Open-Loop)
+    CTRL_CMD_SET_TARGET,     // value = Solldrehzahl in U/min (geregelter Betrieb)
+    CTRL_CMD_SET_PWM_FREQ,   // value = PWM-Frequenz in Hz (Wechsel am Wrap, Duty bleibt)
+    CTRL_CMD_SET_DRIVE_MODE, // value = 0: 6-Step, 1: Sinus (sine.c), Umschalten im Lauf
+    CTRL_CMD_SET_ADVANCE,    // value = Voreilwinkel im Sinus-Betrieb in Grad el.
+    CTRL_CMD_TRAJ_START,     // Trajektorie (traj.h) ab jetzt ausführen, Punkte vorher mit traj_push()
+    CTRL_CMD_TRAJ_STOP,      // Trajektorie abbrechen, Punkte vor Nummer value (traj_pushed() beim Senden) verwerfen
+} ctrl_cmd_type_t;
+
+typedef struct
+{
+    uint8_t type;  // ctrl_cmd_type_t
+    uint8_t motor; // Index in motors[]; weitere Motoren kennen nur FASTER/SLOWER/SET_STEP_TIME
+    uint32_t value;
+} ctrl_cmd_t;
+
+// ---- core1 ----
+// Alle Echtzeitmodule auf dem aufrufenden Kern einrichten (Interrupts landen dort) und starten
+void control_init(void);
+// Ein Durchlauf der Kontrollschleife: Befehle, Fault, Betriebsart, periodische Meldungen
+void control_poll(void);
+
+// ---- core0 ----
+// Befehl an den Hauptantrieb (Motor 0) senden; false, wenn der Ring voll ist
+bool control_send(ctrl_cmd_type_t type, uint32_t value);
+// Befehl an Motor motor senden
+bool control_send_motor(uint motor, ctrl_cmd_type_t type, uint32_t value);
+
+#endif // CONTROL_H
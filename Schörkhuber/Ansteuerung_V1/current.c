@@ -0,0 +1,153 @@
+// current.c
+// PWM-synchrone Strommessung und Zyklus-für-Zyklus-Begrenzung, siehe current.h.
+//
+// Zeitlicher Ablauf je PWM-Periode (mittenzentriert, Zähler 0 = Mitte des LS-Pulses):
+//   Wrap -> DMA kopiert adc_sample[CURRENT_ADC_INPUT] in den Ring (taktgenau, ohne CPU)
+//        -> Wrap-Interrupt liest diesen Wert aus dem Ring und stellt die Duty-Grenze nach.
+// Der ADC läuft frei im Round-Robin der Gegen-EMK (bemf.c) und wird nicht vom Wrap gestartet; der
+// kopierte Wert ist deshalb bis zu CURRENT_SAMPLE_AGE_US alt. Liegt dieser Zeitpunkt nicht mehr
+// im LS-Puls (halber Puls kürzer, bei 20 kHz unter 40 % Duty), stammt der Wert aus der Aus-Phase
+// und sagt nichts über den Strom: solche Perioden werden nicht ausgewertet, die Begrenzung wirkt
+// also nur ab min_level. Darunter schützt allein der FAULT-Eingang des Treibers (fault.c).
+// Eine aktive Grenze geht nur nach gemessenen Perioden ohne Überstrom wieder auf; in nicht
+// messbaren Perioden bleibt sie stehen (liegt sie selbst unter min_level, steigt sie höchstens bis
+// min_level, damit wieder gemessen wird). Das CC-Register ist gepuffert: die neue Grenze gilt
+// ab der nächsten Periode, bis dahin ist der Strom höchstens eine Periode lang zu groß.
+
+#include "current.h"
+#include "bemf.h"
+#include "bldc.h"
+#include "config.h"
+#include "pwm_engine.h"
+
+#if CURRENT_SENSE
+
+#if BLDC_DEADTIME_PIO
+#error "CURRENT_SENSE braucht die LS-PWM der Slices (Wrap-DREQ), nicht die PIO-PWM"
+#endif
+#if !PWM_PHASE_CORRECT
+#error "CURRENT_SENSE braucht mittenzentrierte PWM (PWM_PHASE_CORRECT), sonst liegt der Wrap auf der Schaltflanke"
+#endif
+_Static_assert(CURRENT_ADC_INPUT == BEMF_ADC_INPUTS, "Stromeingang muss direkt nach den Gegen-EMK-Eingängen liegen");
+
+#define RING_LEN ((1u << CURRENT_RING_BITS) / sizeof(uint16_t))
+
+// Ziel der DMA, auf seine Größe ausgerichtet (Ring-Adressierung der DMA)
+static volatile uint16_t ring[RING_LEN] __attribute__((aligned(1u << CURRENT_RING_BITS)));
+static uint ring_dma;   // DMA-Kanal, der bei jedem Wrap schreibt
+static uint wrap_slice; // Slice, dessen Wrap Messung und Interrupt auslöst
+
+// nur der Wrap-Interrupt schreibt
+static volatile uint16_t last;
+static volatile uint16_t peak;
+static volatile uint32_t samples;
+static volatile uint32_t trips;
+static uint16_t limit = PWM_WRAP;
+static uint16_t min_level;     // kleinster Duty, bei dem der Messwert noch im LS-Puls liegt
+static uint32_t min_level_mhz; // PWM-Frequenz, für die min_level berechnet ist
+
+// halber LS-Puls (level / PWM_WRAP * Periode / 2) >= CURRENT_SAMPLE_AGE_US
+static void update_min_level(uint32_t freq_mhz)
+{
+    uint64_t l = (uint64_t)PWM_WRAP * 2u * CURRENT_SAMPLE_AGE_US * freq_mhz / 1000000000u;
+    min_level = l < PWM_WRAP ? (uint16_t)l : PWM_WRAP;
+    min_level_mhz = freq_mhz;
+}
+
+static void current_isr(void)
+{
+    if (!hal_pwm_wrap_pending(wrap_slice))
+        return; // gemeinsamer PWM-Interrupt gilt einem anderen Slice
+    hal_pwm_wrap_clear(wrap_slice);
+
+    uint32_t freq_mhz = pwm_engine_timing()->freq_mhz;
+    if (freq_mhz != min_level_mhz)
+        update_min_level(freq_mhz); // nur nach einem Frequenzwechsel
+    uint16_t level = bldc_level_applied(MAIN_MOTOR);
+    bool valid = level >= min_level;
+
+    uint16_t i = 0;
+    if (valid)
+    {
+        // jüngster Eintrag liegt direkt vor der nächsten Schreibadresse der DMA
+        uint32_t next = (uint32_t)(hal_dma_write_addr(ring_dma) - (uintptr_t)ring) / sizeof(uint16_t);
+        i = ring[(next - 1u) & (RING_LEN - 1u)];
+        last = i;
+        if (i > peak)
+            peak = i;
+        samples++;
+    }
+
+    uint16_t new_limit;
+    if (valid)
+    {
+        if (i > CURRENT_LIMIT_ADC)
+        {
+            // Überstrom: Grenze unter den Duty dieser Periode, wirkt sofort ab der nächsten
+            new_limit = level - (level >> CURRENT_CUT_SHIFT);
+            trips++;
+        }
+        else
+        {
+            // gemessen und in Ordnung: langsam wieder freigeben
+            new_limit = limit > PWM_WRAP - CURRENT_RECOVER_STEP ? PWM_WRAP : limit + CURRENT_RECOVER_STEP;
+        }
+    }
+    else if (level >= limit && limit < min_level)
+    {
+        // nicht messbar, weil die Grenze selbst den Duty unter min_level drückt: nur bis min_level
+        // anheben, dort entscheidet die nächste Messung (sonst bliebe die Grenze für immer stehen)
+        new_limit = limit > min_level - CURRENT_RECOVER_STEP ? min_level : limit + CURRENT_RECOVER_STEP;
+    }
+    else
+    {
+        return; // kleiner Duty vorgegeben, nicht messbar: Grenze halten, nicht ungemessen freigeben
+    }
+
+    if (new_limit != limit)
+    {
+        limit = new_limit;
+        bldc_set_level_limit(MAIN_MOTOR, limit);
+    }
+}
+
+void current_init(void)
+{
+    wrap_slice = MAIN_MOTOR->ls_slice[0]; // alle LS-Slices laufen synchron
+    ring_dma = hal_pwm_wrap_dma_ring(wrap_slice, &bemf_adc_samples()[CURRENT_ADC_INPUT], ring, CURRENT_RING_BITS);
+    hal_pwm_wrap_irq_init(wrap_slice, current_isr, CURRENT_IRQ_PRIORITY, CURRENT_IRQ_ORDER);
+    hal_pwm_wrap_irq_set_enabled(wrap_slice, true);
+}
+
+uint16_t current_last(void)
+{
+    return last;
+}
+
+void current_get_stats(current_stats_t *out)
+{
+    out->samples = samples;
+    out->trips = trips;
+    out->last = last;
+    out->peak = peak;
+    out->limit = limit;
+    peak = 0; // Lesen und Zurücksetzen nicht atomar: im Zweifel fehlt eine Spitze
+}
+
+#else // !CURRENT_SENSE
+
+void current_init(void)
+{
+}
+
+uint16_t current_last(void)
+{
+    return 0;
+}
+
+void current_get_stats(current_stats_t *out)
+{
+    *out = (current_stats_t){0, 0, 0, 0, PWM_WRAP};
+}
+
+#endif // CURRENT_SENSE
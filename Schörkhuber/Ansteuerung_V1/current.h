@@ -0,0 +1,36 @@
+// current.h
+// Strommessung synchron zur PWM und Zyklus-für-Zyklus-Strombegrenzung.
+// Der Shunt-Strom wird im Round-Robin des ADC (bemf.c) mitgewandelt. Bei jedem Wrap der LS-PWM
+// kopiert ein DMA-Kanal den jüngsten Wert in einen Ring; bei mittenzentrierter PWM liegt der
+// Wrap genau in der Mitte des LS-Einschaltpulses, also dort, wo der Shunt den Phasenstrom sieht.
+// Der Wert ist aber bis zu CURRENT_SAMPLE_AGE_US alt und nur gültig, solange der halbe Puls
+// länger ist; bei kleinerem Duty wird nicht gemessen, eine aktive Grenze bleibt dann stehen
+// (siehe current.c).
+// Der Wrap-Interrupt vergleicht den Wert mit CURRENT_LIMIT_ADC und senkt bei Überstrom die
+// Duty-Grenze (bldc_set_level_limit), die dann ab der nächsten Periode gilt.
+// Nur mit CURRENT_SENSE (config.h); sonst tun alle Funktionen nichts bzw. liefern 0.
+
+#ifndef CURRENT_H
+#define CURRENT_H
+
+#include "hal.h"
+
+typedef struct
+{
+    uint32_t samples; // ausgewertete PWM-Perioden (Duty groß genug für eine gültige Messung)
+    uint32_t trips;   // Perioden mit Überstrom
+    uint16_t last;    // jüngster Messwert (ADC-Counts)
+    uint16_t peak;    // größter Messwert seit dem letzten current_get_stats
+    uint16_t limit;   // aktuelle Duty-Grenze (PWM_WRAP = keine Begrenzung)
+} current_stats_t;
+
+// DMA-Ring und Wrap-Interrupt einrichten (core1, nach bldc_init und bemf_init)
+void current_init(void);
+
+// jüngster Messwert in ADC-Counts (0 ohne CURRENT_SENSE)
+uint16_t current_last(void);
+
+// Statistik abholen; setzt den Spitzenwert zurück
+void current_get_stats(current_stats_t *out);
+
+#endif // CURRENT_H
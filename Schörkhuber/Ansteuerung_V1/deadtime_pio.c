@@ -0,0 +1,127 @@
+// deadtime_pio.c
+// PIO-Backend der Leistungsstufe (BLDC_DEADTIME_PIO=1).
+// Ersetzt die Busy-Wait-Totzeit aus bldc.c: die Sequenz
+//     LS aus -> Totzeit -> HS umschalten -> Totzeit -> LS ein
+// läuft in der State-Machine bldc_seq (bldc_seq.pio) mit Systemtakt-Auflösung ab,
+// die CPU schreibt nur ein vorberechnetes Wort in den TX-FIFO.
+//
+// Pinbelegung: alle Brückenpins liegen im Fenster HS_PIN_A .. HS_PIN_A+9.
+// HS-Pins: Ausgangswert fest LOW, Richtung durch bldc_seq -> wie hs_drive_mask().
+// LS-Pins: Pegel aus je einer ls_pwm State-Machine, Richtung durch bldc_seq.
+//          Hochohmig = aus, genau wie der Output-Enable-Override im SIO/PWM-Backend.
+
+#include "config.h"
+
+#if BLDC_DEADTIME_PIO
+
+#include "bldc.h"
+#include "bldc_seq.pio.h" // von pioasm erzeugt (pico_generate_pio_header)
+#include "deadtime_pio.h"
+#include "hardware/clocks.h"
+#include "hardware/pio.h"
+
+#define SEQ_PIO pio0
+#define SEQ_SM 0 // Sequencer; SM1..3 = PWM Phase A..C
+
+// Bitposition eines Pins im 10-bit Fenster des Sequencers
+#define REL(pin) (1u << ((pin) - HS_PIN_A))
+#define HS_REL(ph) ((ph) == 0 ? REL(HS_PIN_A) : (ph) == 1 ? REL(HS_PIN_B) : REL(HS_PIN_C))
+#define LS_REL(ph) ((ph) == 0 ? REL(LS_PIN_A) : (ph) == 1 ? REL(LS_PIN_B) : REL(LS_PIN_C))
+
+_Static_assert(HS_PIN_A <= HS_PIN_B && HS_PIN_A <= HS_PIN_C && HS_PIN_A <= LS_PIN_A &&
+                   HS_PIN_A <= LS_PIN_B && HS_PIN_A <= LS_PIN_C,
+               "HS_PIN_A muss der niedrigste Brückenpin sein (Basis des PIO-Fensters)");
+_Static_assert(HS_PIN_C - HS_PIN_A < 10 && LS_PIN_C - HS_PIN_A < 10 && LS_PIN_B - HS_PIN_A < 10,
+               "Alle Brückenpins müssen in 10 aufeinanderfolgenden GPIOs liegen");
+
+// Ein FIFO-Wort = drei Richtungsmasken: [9:0] alte HS, LS aus | [19:10] neue HS | [29:20] neue HS + LS.
+// Es setzt sich aus einem Anteil des vorherigen und einem des neuen Schritts zusammen,
+// beide Tabellen entstehen zur Compile-Zeit aus COMMUTATION_SEQUENCE.
+#define SEQ_PREV_ENTRY(hs, ls) HS_REL(hs),
+#define SEQ_NEXT_ENTRY(hs, ls) (HS_REL(hs) << 10) | ((HS_REL(hs) | LS_REL(ls)) << 20),
+static const uint32_t SEQ_PREV[6] = {COMMUTATION_SEQUENCE(SEQ_PREV_ENTRY)};
+static const uint32_t SEQ_NEXT[6] = {COMMUTATION_SEQUENCE(SEQ_NEXT_ENTRY)};
+
+// Alle sechs Pins als Maske (absolute GPIO-Nummern)
+#define BRIDGE_MASK ((1u << HS_PIN_A) | (1u << HS_PIN_B) | (1u << HS_PIN_C) | \
+                     (1u << LS_PIN_A) | (1u << LS_PIN_B) | (1u << LS_PIN_C))
+
+static uint seq_offset;     // Startadresse von bldc_seq im Befehlsspeicher
+static uint32_t pwm_period; // PIO-PWM Periode in Zählschritten
+static uint16_t last_level; // zuletzt gesetzter Duty (0..PWM_WRAP)
+
+// 32-bit Wert per FIFO in das ISR einer (angehaltenen) State-Machine laden
+static void load_isr(uint sm, uint32_t value)
+{
+    pio_sm_put_blocking(SEQ_PIO, sm, value);
+    pio_sm_exec(SEQ_PIO, sm, pio_encode_pull(false, false));
+    pio_sm_exec(SEQ_PIO, sm, pio_encode_out(pio_isr, 32));
+}
+
+// ns -> Schleifenzahl N (Flanke-zu-Flanke = N+3 Takte, siehe bldc_seq.pio)
+static uint32_t ns_to_loops(uint32_t ns)
+{
+    uint32_t cycles = (uint32_t)(((uint64_t)ns * clock_get_hz(clk_sys) + 999999999u) / 1000000000u);
+    return cycles > 3 ? cycles - 3 : 0;
+}
+
+void deadtime_pio_init(uint32_t dead_time_ns)
+{
+    seq_offset = pio_add_program(SEQ_PIO, &bldc_seq_program);
+    uint pwm_offset = pio_add_program(SEQ_PIO, &ls_pwm_program);
+
+    // Sequencer: Fenster ab HS_PIN_A, HS-Pegel fest LOW, alle Richtungen Eingang
+    bldc_seq_program_init(SEQ_PIO, SEQ_SM, seq_offset, HS_PIN_A);
+    pio_sm_set_pins_with_mask(SEQ_PIO, SEQ_SM, 0, BRIDGE_MASK);
+    pio_sm_set_pindirs_with_mask(SEQ_PIO, SEQ_SM, 0, BRIDGE_MASK);
+    load_isr(SEQ_SM, ns_to_loops(dead_time_ns));
+
+    // PWM: 3 Takte pro Zählschritt -> Periode für PWM_FREQ
+    pwm_period = clock_get_hz(clk_sys) / (3u * PWM_FREQ);
+    for (uint ph = 0; ph < 3; ++ph)
+    {
+        ls_pwm_program_init(SEQ_PIO, SEQ_SM + 1 + ph, pwm_offset, MAIN_MOTOR->ls_pin[ph]);
+        load_isr(SEQ_SM + 1 + ph, pwm_period);
+        pio_sm_put_blocking(SEQ_PIO, SEQ_SM + 1 + ph, 0); // Duty 0
+    }
+    last_level = 0;
+
+    // erst jetzt die Pins an PIO0 übergeben (vorher hochohmig durch gpio_init in bldc_init)
+    for (uint ph = 0; ph < 3; ++ph)
+    {
+        pio_gpio_init(SEQ_PIO, MAIN_MOTOR->hs_pin[ph]);
+        pio_gpio_init(SEQ_PIO, MAIN_MOTOR->ls_pin[ph]);
+    }
+
+    // alle vier State-Machines im selben Takt starten
+    pio_enable_sm_mask_in_sync(SEQ_PIO, 0xfu);
+}
+
+void deadtime_pio_step(int prev, int next)
+{
+    uint32_t word = SEQ_NEXT[next] | (prev >= 0 ? SEQ_PREV[prev] : 0u);
+    pio_sm_put(SEQ_PIO, SEQ_SM, word); // FIFO hat 4 Plätze, eine Sequenz dauert < 1 µs
+}
+
+void deadtime_pio_all_off(void)
+{
+    // Sequencer anhalten, ausstehende Wörter verwerfen und alle Richtungen auf Eingang
+    pio_sm_set_enabled(SEQ_PIO, SEQ_SM, false);
+    pio_sm_clear_fifos(SEQ_PIO, SEQ_SM);
+    pio_sm_exec(SEQ_PIO, SEQ_SM, pio_encode_mov(pio_osr, pio_null));
+    pio_sm_exec(SEQ_PIO, SEQ_SM, pio_encode_out(pio_pindirs, 10));
+    pio_sm_exec(SEQ_PIO, SEQ_SM, pio_encode_jmp(seq_offset)); // zurück auf "pull block"
+    pio_sm_set_enabled(SEQ_PIO, SEQ_SM, true);
+}
+
+void deadtime_pio_set_level(uint16_t level)
+{
+    if (level == last_level)
+        return;
+    last_level = level;
+    uint32_t pio_level = (uint32_t)level * pwm_period / (PWM_WRAP + 1u);
+    for (uint ph = 0; ph < 3; ++ph)
+        pio_sm_put(SEQ_PIO, SEQ_SM + 1 + ph, pio_level); // wird am nächsten Periodenanfang übernommen
+}
+
+#endif // BLDC_DEADTIME_PIO
@@ -0,0 +1,25 @@
+// deadtime_pio.h
+// Taktgenaue Totzeit über PIO (nur mit BLDC_DEADTIME_PIO=1, siehe config.h).
+// Die sechs Brückenpins gehören dann PIO0: SM0 spielt die Schaltsequenz mit
+// Totzeiten in 8 ns Schritten ab, SM1..3 erzeugen die Low-Side PWM.
+// Die CPU legt pro Kommutation nur noch ein Wort in den FIFO und wartet nicht.
+// Die Totzeit steht zur Compile-Zeit fest (DEAD_TIME_NS) und wird nur in deadtime_pio_init geladen.
+
+#ifndef DEADTIME_PIO_H
+#define DEADTIME_PIO_H
+
+#include <stdint.h>
+
+// PIO-Programme laden, Pins übernehmen, State-Machines synchron starten (alles aus)
+void deadtime_pio_init(uint32_t dead_time_ns);
+
+// Übergang vom Schritt prev (-1 = alles aus) nach next anstoßen (kehrt sofort zurück)
+void deadtime_pio_step(int prev, int next);
+
+// Sofort alle sechs Ausgänge hochohmig, laufende Sequenz verwerfen
+void deadtime_pio_all_off(void);
+
+// Duty aller Low-Sides setzen (0..PWM_WRAP, wird auf die PIO-Periode skaliert)
+void deadtime_pio_set_level(uint16_t level);
+
+#endif // DEADTIME_PIO_H
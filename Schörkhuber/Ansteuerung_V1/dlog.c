@@ -0,0 +1,36 @@
+// dlog.c
+// Ring und Ausgabe des verzögerten Loggings (siehe dlog.h).
+
+#include "dlog.h"
+#include "spsc.h"
+
+#include <stdio.h>
+
+SPSC_DEFINE(dlog_ring, dlog_entry_t, DLOG_RING_SIZE); // core1 -> core0
+
+static volatile uint32_t dlog_lost; // nur core1 schreibt
+
+void dlog_write(const char *fmt, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4)
+{
+    dlog_entry_t e = {fmt, {a0, a1, a2, a3, a4}};
+    if (!spsc_push(&dlog_ring, &e))
+        dlog_lost++;
+}
+
+uint dlog_flush(void)
+{
+    dlog_entry_t e;
+    uint n = 0;
+    while (spsc_pop(&dlog_ring, &e))
+    {
+        // nicht benutzte Argumente werden von printf ignoriert
+        printf(e.fmt, e.arg[0], e.arg[1], e.arg[2], e.arg[3], e.arg[4]);
+        n++;
+    }
+    return n;
+}
+
+uint32_t dlog_dropped(void)
+{
+    return dlog_lost;
+}
@@ -0,0 +1,44 @@
+// dlog.h
+// Verzögertes Logging (deferred log) von core1 nach core0.
+// printf auf der UART-stdio blockiert bei 115200 Baud rund 1 ms pro Zeile. Deshalb speichert
+// DLOG() im Echtzeitteil nur den Zeiger auf den Formatstring und bis zu DLOG_MAX_ARGS rohe
+// 32-bit Argumente in einem SPSC-Ring (spsc.h); formatiert und ausgegeben wird erst auf core0
+// mit dlog_flush(). Kosten am Aufrufort: Eintrag füllen + spsc_push, einige Dutzend Takte.
+//
+//   DLOG("Speed %s -> step_time_us=%u\n", ...) geht NICHT: %s bräuchte den String zur Laufzeit.
+//   Texte, die vom Zustand abhängen, als zwei Formatstrings schreiben:
+//   DLOG(up ? "Speed UP -> step_time_us=%u\n" : "Speed DOWN -> step_time_us=%u\n", t);
+//
+// Regeln: Formatstring muss ein String-Literal sein (der Zeiger wird erst später benutzt),
+// Argumente nur %u/%d/%x (je 32 bit). Genau ein Erzeuger: die Kontrollschleife auf core1.
+// Ist der Ring voll, wird die Meldung verworfen und gezählt (core1 wartet nie).
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include "hal.h"
+
+#define DLOG_MAX_ARGS 5
+#define DLOG_RING_SIZE 32 // Meldungen im Ring (2^n)
+
+typedef struct
+{
+    const char *fmt; // String-Literal im Flash
+    uint32_t arg[DLOG_MAX_ARGS];
+} dlog_entry_t;
+
+// ---- core1 ----
+void dlog_write(const char *fmt, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4);
+
+// DLOG(fmt, ...) mit 0..5 Argumenten, fehlende werden mit 0 aufgefüllt
+#define DLOG(...) DLOG_(__VA_ARGS__, 0, 0, 0, 0, 0, 0)
+#define DLOG_(fmt, a0, a1, a2, a3, a4, ...) \
+    dlog_write(fmt, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3), (uint32_t)(a4))
+
+// ---- core0 ----
+// Gespeicherte Meldungen formatieren und mit printf ausgeben; Rückgabe: Anzahl
+uint dlog_flush(void);
+// Meldungen, die core1 wegen vollem Ring verwerfen musste
+uint32_t dlog_dropped(void);
+
+#endif // DLOG_H
@@ -0,0 +1,120 @@
+// fault.c
+// Not-Aus / Fault per Flanken-Interrupt statt Polling.
+// Vorher wurde is_fault_active() nur alle POLL_MS in der Hauptschleife und bei jedem
+// Kommutationsschritt gelesen; ein Überstrom konnte so bis zu 10 ms anstehen.
+// Jetzt läuft der Bank-0-Interrupt mit höchster NVIC-Priorität, dieser Handler zuerst. Er
+// unterbricht die Kommutation (Alarm- und PWM-Wrap-Interrupt, COMM_IRQ_PRIORITY). Den Bank-0-
+// Interrupt teilt er sich auf core1 nur mit hall.c, und der schaltet selbst nichts, sondern stößt
+// den Kommutations-Alarm an: ein laufender Schritt kann den Fault also nie aufhalten, und nach
+// dem Fault-Handler sieht jeder Einschaltvorgang das Latch. Ausgelöst wird nur auf der Flanke in den
+// Fehlerzustand, deshalb wird ohne erneutes Lesen der Pins abgeschaltet: auch ein kurzer
+// Überstrompuls, der beim Interrupt-Eintritt schon vorbei ist, wird gespeichert.
+// Mehrere Motoren: E-Stop schaltet alle ab, der FAULT-Eingang eines Motors nur diesen.
+
+#include "fault.h"
+#include "bldc.h"
+#include "config.h"
+#include "perf.h"
+
+#define CYCLES_MASK 0x00ffffffu // SysTick ist 24 bit breit
+
+// Alles, was Ausgänge einschaltet, muss vom Fault-Interrupt unterbrochen werden können
+_Static_assert(FAULT_IRQ_PRIORITY < COMM_IRQ_PRIORITY && FAULT_IRQ_PRIORITY < CURRENT_IRQ_PRIORITY &&
+                   FAULT_IRQ_PRIORITY < SPEED_IRQ_PRIORITY,
+               "Fault-Interrupt muss über Kommutation, PWM-Wrap und Drehzahlregler liegen");
+
+static uint32_t fault_mask;                   // E-Stop + FAULT-Eingänge aller Motoren
+static volatile fault_stats_t stats;          // schreibt nur der Interrupt
+static volatile bool selftest_active = false; // nächster Interrupt ist ein erzwungener Testlauf
+static volatile uint32_t selftest_start;      // Takt beim Erzwingen
+static volatile uint32_t selftest_cycles;     // gemessene Dauer, 0 = noch nicht fertig
+
+static uint32_t cycles_to_ns(uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 1000000000u / hal_clock_sys_hz());
+}
+
+// Bank-0-Interrupt (Raw-Handler, Reihenfolge FAULT_IRQ_ORDER = zuerst)
+static void fault_isr(void)
+{
+    uint32_t entry = hal_cycles(); // so früh wie möglich
+    uint32_t pending = hal_gpio_irq_status(fault_mask);
+    if (!pending)
+        return; // Interrupt gilt einem anderen Modul
+
+    // zuerst abschalten, alles andere danach
+    if (selftest_active || (pending & (1u << ESTOP_PIN)))
+        bldc_emergency_off_all();
+    else
+        for (uint i = 0; i < MOTOR_COUNT; ++i)
+            if (motors[i].fault_pin != MOTOR_NO_PIN && (pending & (1u << motors[i].fault_pin)))
+                bldc_emergency_off(&motors[i]);
+    uint32_t off = hal_cycles();
+
+    if (selftest_active)
+    {
+        hal_gpio_irq_force(FAULT_PIN, false); // erzwungenen Interrupt zurücknehmen
+        selftest_active = false;
+        selftest_cycles = ((off - selftest_start) & CYCLES_MASK) | 1u; // nie 0 (= fertig)
+        return;
+    }
+
+    hal_gpio_irq_ack(pending);
+    uint32_t cycles = (off - entry) & CYCLES_MASK;
+    perf_add(PERF_FAULT, (int32_t)cycles); // Histogramm für STATS (Umrechnung erst bei der Ausgabe)
+    uint32_t ns = cycles_to_ns(cycles);
+    stats.count++;
+    stats.last_ns = ns;
+    if (ns > stats.max_ns)
+        stats.max_ns = ns;
+    stats.latched_us = hal_time_us_32();
+}
+
+void fault_init(void)
+{
+    hal_cycles_init();
+    fault_mask = (1u << ESTOP_PIN) | bldc_fault_pins_mask();
+    hal_gpio_irq_init(fault_mask, fault_isr, FAULT_IRQ_ORDER);
+    hal_gpio_irq_set_edges(ESTOP_PIN, false, true); // active LOW: fallende Flanke = Not-Aus
+    for (uint32_t m = bldc_fault_pins_mask(); m; m &= m - 1u)
+        hal_gpio_irq_set_edges((uint)__builtin_ctz(m), true, false); // active HIGH: steigende Flanke = Fehler
+    hal_gpio_irq_set_priority(FAULT_IRQ_PRIORITY);
+
+    // Flanken vor dem Freigeben gehen verloren: anliegenden Fehler einmal per Pegel prüfen
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+        if (is_fault_active(&motors[i]))
+            bldc_emergency_off(&motors[i]);
+}
+
+void fault_get_stats(fault_stats_t *out)
+{
+    uint32_t irq = hal_irq_save();
+    out->count = stats.count;
+    out->last_ns = stats.last_ns;
+    out->max_ns = stats.max_ns;
+    out->latched_us = stats.latched_us;
+    hal_irq_restore(irq);
+}
+
+void fault_selftest(uint32_t runs, uint32_t *min_ns, uint32_t *max_ns)
+{
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (uint32_t i = 0; i < runs; ++i)
+    {
+        selftest_cycles = 0;
+        selftest_active = true;
+        selftest_start = hal_cycles();
+        hal_gpio_irq_force(FAULT_PIN, true); // Interrupt kommt sofort (höchste Priorität)
+        while (selftest_cycles == 0)
+            ;
+        uint32_t ns = cycles_to_ns(selftest_cycles);
+        if (ns < lo)
+            lo = ns;
+        if (ns > hi)
+            hi = ns;
+    }
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+        bldc_fault_clear(&motors[i]); // nur wirksam, wenn kein echter Fehler anliegt
+    *min_ns = lo;
+    *max_ns = hi;
+}
@@ -0,0 +1,35 @@
+// fault.h
+// E-Stop/FAULT im Interrupt: eine Flanke in den Fehlerzustand (ESTOP fällt, FAULT steigt)
+// schaltet sofort die Ausgänge ab und speichert den Fehler: E-Stop alle Motoren
+// (bldc_emergency_off_all), der FAULT-Eingang eines Motors nur diesen (bldc_emergency_off).
+// Gelöscht wird er nur ausdrücklich mit bldc_fault_clear() aus der Kontrollschleife.
+// Die Reaktionszeit wird in Prozessortakten gemessen (SysTick, siehe hal_cycles).
+
+#ifndef FAULT_H
+#define FAULT_H
+
+#include "hal.h"
+
+// Messwerte der echten Fehlerereignisse: Interrupt-Eintritt bis Ausgänge aus
+typedef struct
+{
+    uint32_t count;      // ausgelöste Not-Abschaltungen
+    uint32_t last_ns;    // Reaktionszeit der letzten
+    uint32_t max_ns;     // größte Reaktionszeit
+    uint32_t latched_us; // Zeitstempel der letzten (timerawl)
+} fault_stats_t;
+
+// Nach bldc_init(): Flanken-Interrupt mit höchster Priorität einrichten (auf dem aufrufenden Kern).
+// Liegt ein Fehler schon an, wird sofort abgeschaltet und gespeichert.
+void fault_init(void);
+
+// Kopie der Messwerte
+void fault_get_stats(fault_stats_t *out);
+
+// Latenz-Selbsttest: runs-mal den Interrupt per Software erzwingen (INTF) und die Zeit vom
+// Auslösen bis "Ausgänge aus" (aller Motoren) messen. Enthält damit auch NVIC-Eintritt und SDK-Verteiler.
+// Nur bei stehendem Motor aufrufen; das Latch wird danach wieder gelöscht, falls kein
+// echter Fehler anliegt. Ergebnis in ns.
+void fault_selftest(uint32_t runs, uint32_t *min_ns, uint32_t *max_ns);
+
+#endif // FAULT_H
@@ -0,0 +1,261 @@
+// hal.h
+// Dünne Hardware-Abstraktion über die Pico-SDK Aufrufe, die die Steuerlogik braucht
+// (GPIO, PWM, Timer/Alarm, ADC). Auf dem RP2040 sind das nur static inline Weiterleitungen,
+// der Compiler erzeugt also denselben Code wie mit direkten SDK-Aufrufen.
+// Im Host-Build (BLDC_HOST, siehe host/) kommen die Funktionen stattdessen aus
+// host/hal_mock.c, das jeden Aufruf mitzählt und den Pinzustand nachbildet.
+
+#ifndef HAL_H
+#define HAL_H
+
+#ifdef BLDC_HOST
+
+#include "hal_mock.h" // gleiche Signaturen, implementiert als Aufzeichnungs-Mock
+
+#else
+
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "hardware/structs/iobank0.h"
+#include "hardware/structs/systick.h"
+#include "hardware/timer.h"
+#include "hardware/uart.h"
+#include "pico/stdlib.h"
+
+// -------------------- GPIO --------------------
+static inline void hal_gpio_init(uint pin) { gpio_init(pin); }
+static inline void hal_gpio_set_function(uint pin, enum gpio_function fn) { gpio_set_function(pin, fn); }
+static inline void hal_gpio_set_dir(uint pin, bool out) { gpio_set_dir(pin, out); }
+static inline void hal_gpio_put(uint pin, bool value) { gpio_put(pin, value); }
+static inline bool hal_gpio_get(uint pin) { return gpio_get(pin); }
+static inline void hal_gpio_pull_up(uint pin) { gpio_pull_up(pin); }
+static inline void hal_gpio_pull_down(uint pin) { gpio_pull_down(pin); }
+static inline void hal_gpio_disable_pulls(uint pin) { gpio_disable_pulls(pin); }
+static inline void hal_gpio_set_dir_masked(uint32_t mask, uint32_t value) { gpio_set_dir_masked(mask, value); } // ein SIO-Zugriff für alle Pins in mask
+static inline void hal_gpio_set_oeover(uint pin, uint value) { gpio_set_oeover(pin, value); }                   // GPIO_OVERRIDE_LOW = Treiber aus
+static inline uint32_t hal_gpio_get_all(void) { return gpio_get_all(); }                                        // alle Eingänge mit einem SIO-Zugriff
+
+static inline void hal_gpio_set_dir_in_masked(uint32_t mask) { gpio_set_dir_in_masked(mask); } // ein Schreibzugriff (gpio_oe_clr)
+
+// Flanken-Interrupt (beide Flanken) für alle Pins in mask. isr wird als eigener Raw-Handler
+// der Bank 0 eingetragen, damit mehrere Module (Hall, Fault, Taster) nebeneinander bestehen;
+// order legt die Aufrufreihenfolge fest (0xff = zuerst). Die Hardware ruft bei jedem Bank-0-
+// Interrupt alle Raw-Handler auf: jeder prüft mit hal_gpio_irq_status(), ob seine Pins
+// gemeint sind, und quittiert sie selbst mit hal_gpio_irq_ack().
+static inline void hal_gpio_irq_init(uint32_t mask, irq_handler_t isr, uint8_t order)
+{
+    gpio_add_raw_irq_handler_with_order_priority_masked(mask, isr, order);
+    for (uint32_t m = mask; m; m &= m - 1u)
+        gpio_set_irq_enabled((uint)__builtin_ctz(m), GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+}
+// Nur bestimmte Flanken eines Pins melden (nach hal_gpio_irq_init)
+static inline void hal_gpio_irq_set_edges(uint pin, bool rise, bool fall)
+{
+    gpio_set_irq_enabled(pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, false);
+    gpio_set_irq_enabled(pin, (rise ? GPIO_IRQ_EDGE_RISE : 0u) | (fall ? GPIO_IRQ_EDGE_FALL : 0u), true);
+}
+// NVIC-Priorität des gemeinsamen Bank-0-Interrupts (gilt für alle GPIO-Handler des Kerns)
+static inline void hal_gpio_irq_set_priority(uint8_t priority) { irq_set_priority(IO_IRQ_BANK0, priority); }
+// Interrupt-Kontrollregister des aufrufenden Kerns
+static inline io_irq_ctrl_hw_t *hal_gpio_irq_ctrl(void)
+{
+    return get_core_num() ? &io_bank0_hw->proc1_irq_ctrl : &io_bank0_hw->proc0_irq_ctrl;
+}
+// Pins aus mask, für die ein (auch erzwungenes) Ereignis ansteht
+static inline uint32_t hal_gpio_irq_status(uint32_t mask)
+{
+    io_irq_ctrl_hw_t *c = hal_gpio_irq_ctrl();
+    uint32_t pending = 0;
+    for (uint32_t m = mask; m; m &= m - 1u)
+    {
+        uint pin = (uint)__builtin_ctz(m);
+        if ((c->ints[pin >> 3] >> (4 * (pin & 7u))) & 0xfu)
+            pending |= 1u << pin;
+    }
+    return pending;
+}
+static inline void hal_gpio_irq_ack(uint32_t mask)
+{
+    for (uint32_t m = mask; m; m &= m - 1u)
+        gpio_acknowledge_irq((uint)__builtin_ctz(m), GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL);
+}
+// Interrupt per Software erzwingen (INTF), z. B. für Latenzmessungen. Bleibt aktiv, bis er
+// mit force = false wieder gelöscht wird.
+static inline void hal_gpio_irq_force(uint pin, bool force)
+{
+    io_irq_ctrl_hw_t *c = hal_gpio_irq_ctrl();
+    if (force)
+        hw_set_bits(&c->intf[pin >> 3], GPIO_IRQ_EDGE_RISE << (4 * (pin & 7u)));
+    else
+        hw_clear_bits(&c->intf[pin >> 3], GPIO_IRQ_EDGE_RISE << (4 * (pin & 7u)));
+}
+
+// -------------------- Interrupts --------------------
+// Interrupts des aufrufenden Kerns kurz sperren (wenige Takte, z. B. Prüfen + Schalten)
+static inline uint32_t hal_irq_save(void) { return save_and_disable_interrupts(); }
+static inline void hal_irq_restore(uint32_t state) { restore_interrupts(state); }
+
+// -------------------- PWM --------------------
+static inline uint hal_pwm_gpio_to_slice_num(uint pin) { return pwm_gpio_to_slice_num(pin); }
+static inline uint hal_pwm_gpio_to_channel(uint pin) { return pwm_gpio_to_channel(pin); }
+static inline void hal_pwm_set_wrap(uint slice, uint16_t wrap) { pwm_set_wrap(slice, wrap); }
+static inline void hal_pwm_set_clkdiv_int_frac(uint slice, uint8_t div_int, uint8_t div_frac) { pwm_set_clkdiv_int_frac(slice, div_int, div_frac); } // Teiler int + frac/16, wirkt sofort
+static inline void hal_pwm_set_phase_correct(uint slice, bool phase_correct) { pwm_set_phase_correct(slice, phase_correct); }                        // auf/ab zählen (mittenzentriert)
+static inline void hal_pwm_set_counter(uint slice, uint16_t c) { pwm_set_counter(slice, c); }
+static inline void hal_pwm_wrap_clear(uint slice) { pwm_clear_irq(slice); }                  // Wrap-Flag (INTR, roh) löschen
+static inline bool hal_pwm_wrap_pending(uint slice) { return (pwm_hw->intr >> slice) & 1u; } // seit dem Löschen gewrappt?
+static inline void hal_pwm_set_chan_level(uint slice, uint chan, uint16_t level) { pwm_set_chan_level(slice, chan, level); }
+static inline void hal_pwm_set_enabled(uint slice, bool enabled) { pwm_set_enabled(slice, enabled); }
+static inline void hal_pwm_set_mask_enabled(uint32_t mask) { pwm_set_mask_enabled(mask); } // alle Slices gleichzeitig
+static inline uint32_t hal_clock_sys_hz(void) { return clock_get_hz(clk_sys); }
+
+// -------------------- Speicherbarriere --------------------
+// Reihenfolge von Speicherzugriffen zwischen den Kernen festlegen (SPSC-Ringe, spsc.h)
+static inline void hal_mem_barrier(void) { __dmb(); }
+
+// -------------------- Zyklenzähler --------------------
+// SysTick als freilaufender 24-bit Zähler im Systemtakt (Auflösung 8 ns bei 125 MHz) für
+// Latenzmessungen unterhalb der 1 µs des Timers. Differenz: (b - a) & 0xffffff.
+static inline void hal_cycles_init(void)
+{
+    systick_hw->rvr = 0x00ffffffu; // größter Nachladewert
+    systick_hw->cvr = 0;           // Zähler zurücksetzen
+    systick_hw->csr = 0x5u;        // Quelle = Prozessortakt, Zähler an, kein Interrupt
+}
+static inline uint32_t hal_cycles(void) { return 0x00ffffffu - systick_hw->cvr; } // SysTick zählt abwärts
+
+// -------------------- Zeit --------------------
+static inline uint32_t hal_time_us_32(void) { return timer_hw->timerawl; } // 1 MHz Timer, untere 32 bit
+static inline uint32_t hal_time_ms(void) { return to_ms_since_boot(get_absolute_time()); }
+static inline void hal_busy_wait_us(uint32_t us) { busy_wait_us_32(us); } // auch im Interrupt erlaubt
+static inline void hal_sleep_ms(uint32_t ms) { sleep_ms(ms); }
+
+// -------------------- Alarm (Kommutations-Scheduler, Drehzahlregler) --------------------
+// Alarm reservieren und isr mit der NVIC-Priorität priority (0x00 = höchste) als exklusiven Handler eintragen
+static inline void hal_alarm_init(uint alarm, irq_handler_t isr, uint8_t priority)
+{
+    hardware_alarm_claim(alarm);                         // Alarm für uns reservieren (SDK nutzt ihn dann nicht)
+    irq_set_exclusive_handler(TIMER_IRQ_0 + alarm, isr); // eigener Handler statt SDK-Callback
+    irq_set_priority(TIMER_IRQ_0 + alarm, priority);
+    hw_set_bits(&timer_hw->inte, 1u << alarm); // Alarm-Interrupt im Timer freigeben
+    irq_set_enabled(TIMER_IRQ_0 + alarm, true);
+}
+static inline void hal_alarm_arm(uint alarm, uint32_t target_us) { timer_hw->alarm[alarm] = target_us; } // Schreiben schaltet scharf
+static inline void hal_alarm_disarm(uint alarm) { timer_hw->armed = 1u << alarm; }                       // 1 schreiben entschärft
+static inline void hal_alarm_ack(uint alarm) { hw_clear_bits(&timer_hw->intr, 1u << alarm); }
+static inline void hal_alarm_irq_set_enabled(uint alarm, bool enabled) { irq_set_enabled(TIMER_IRQ_0 + alarm, enabled); }
+// Alarm-Interrupt ohne Termin anstoßen (NVIC pending): läuft, sobald keine höher priorisierte
+// Behandlung mehr aktiv ist, z. B. direkt nach dem auslösenden GPIO-Interrupt
+static inline void hal_alarm_pend(uint alarm) { irq_set_pending(TIMER_IRQ_0 + alarm); }
+
+// -------------------- ADC (Gegen-EMK) --------------------
+// ADC-Eingänge 0..n-1 frei laufend reihum wandeln (max. 500 kS/s); ein DMA-Kanal schreibt jede
+// Runde nach buf[0..n-1], ein zweiter setzt danach die Zieladresse zurück. buf[i] enthält so
+// immer den jüngsten Wert von Eingang i, ohne dass die CPU etwas tun muss.
+static inline void hal_adc_stream_start(volatile uint16_t *buf, uint n)
+{
+    static volatile uint16_t *restart_addr; // wird vom Steuerkanal nach jeder Runde nachgeladen
+    restart_addr = buf;
+
+    adc_init();
+    for (uint i = 0; i < n; ++i)
+        adc_gpio_init(26 + i); // ADC-Eingang i = GPIO 26+i
+    adc_select_input(0);
+    adc_set_round_robin((1u << n) - 1u);
+    adc_fifo_setup(true, true, 1, false, false); // FIFO an, DREQ ab 1 Wert, 12 bit ohne Shift
+    adc_set_clkdiv(0);                           // so schnell wie möglich (96 Takte pro Wandlung)
+
+    uint data = dma_claim_unused_channel(true);
+    uint ctrl = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(data);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    channel_config_set_chain_to(&c, ctrl); // nach n Werten: Steuerkanal startet Runde neu
+    dma_channel_configure(data, &c, buf, &adc_hw->fifo, n, false);
+
+    dma_channel_config k = dma_channel_get_default_config(ctrl);
+    channel_config_set_transfer_data_size(&k, DMA_SIZE_32);
+    channel_config_set_read_increment(&k, false);
+    channel_config_set_write_increment(&k, false);
+    dma_channel_configure(ctrl, &k, &dma_hw->ch[data].al2_write_addr_trig, &restart_addr, 1, false);
+
+    dma_channel_start(data);
+    adc_run(true);
+}
+
+// -------------------- PWM-Wrap: Interrupt und DMA-Takt (Strommessung) --------------------
+// Handler für den Wrap-Interrupt eines Slices registrieren (noch nicht freigegeben). Der
+// PWM-Interrupt ist für alle Slices gemeinsam: mehrere Module hängen sich mit eigener
+// Reihenfolge an und nutzen je einen eigenen Slice (alle LS-Slices laufen synchron);
+// jeder Handler prüft zuerst sein Wrap-Flag (hal_pwm_wrap_pending).
+static inline void hal_pwm_wrap_irq_init(uint slice, irq_handler_t isr, uint8_t priority, uint8_t order)
+{
+    pwm_clear_irq(slice);
+    irq_add_shared_handler(PWM_IRQ_WRAP, isr, order);
+    irq_set_priority(PWM_IRQ_WRAP, priority);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+}
+static inline void hal_pwm_wrap_irq_set_enabled(uint slice, bool enabled) { pwm_set_irq_enabled(slice, enabled); }
+// Bei jedem Wrap von slice kopiert ein DMA-Kanal *src in den Ring (2^ring_bits Byte, auf seine
+// Größe ausgerichtet). Ein zweiter Kanal lädt den Zähler nach, damit das endlos läuft.
+// Rückgabe: Datenkanal (für hal_dma_write_addr)
+static inline uint hal_pwm_wrap_dma_ring(uint slice, const volatile uint16_t *src, volatile uint16_t *ring, uint ring_bits)
+{
+    static const uint32_t reload = 0xffffffffu; // Transfers bis zum Nachladen (~2,5 Tage bei 20 kHz)
+
+    uint data = dma_claim_unused_channel(true);
+    uint ctrl = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(data);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, ring_bits); // Schreibadresse läuft im Ring um
+    channel_config_set_dreq(&c, DREQ_PWM_WRAP0 + slice);
+    channel_config_set_chain_to(&c, ctrl);
+    dma_channel_configure(data, &c, ring, src, reload, false);
+
+    dma_channel_config k = dma_channel_get_default_config(ctrl);
+    channel_config_set_transfer_data_size(&k, DMA_SIZE_32);
+    channel_config_set_read_increment(&k, false);
+    channel_config_set_write_increment(&k, false);
+    dma_channel_configure(ctrl, &k, &dma_hw->ch[data].al1_transfer_count_trig, &reload, 1, false);
+
+    dma_channel_start(data);
+    return data;
+}
+// nächste Schreibadresse eines DMA-Kanals (der jüngste Wert liegt direkt davor)
+static inline uintptr_t hal_dma_write_addr(uint chan) { return (uintptr_t)dma_hw->ch[chan].write_addr; }
+
+// -------------------- UART mit DMA (Telemetrie) --------------------
+// uart1 nur senden: ein DMA-Kanal schiebt den Puffer im Takt der UART (DREQ) ins Datenregister.
+// Rückgabe: DMA-Kanal für hal_uart_dma_send/hal_uart_dma_busy.
+static inline uint hal_uart_dma_init(uint tx_pin, uint baud)
+{
+    uart_init(uart1, baud);
+    gpio_set_function(tx_pin, GPIO_FUNC_UART);
+
+    uint chan = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, uart_get_dreq(uart1, true));
+    dma_channel_configure(chan, &c, &uart_get_hw(uart1)->dr, NULL, 0, false);
+    return chan;
+}
+static inline void hal_uart_dma_send(uint chan, const void *buf, uint len) { dma_channel_transfer_from_buffer_now(chan, buf, len); }
+static inline bool hal_uart_dma_busy(uint chan) { return dma_channel_is_busy(chan); }
+
+#endif // BLDC_HOST
+
+#endif // HAL_H
@@ -0,0 +1,135 @@
+// hall.c
+// Hall-Sensor-Kommutation mit Flanken-Zeitstempel.
+// Im Open-Loop muss step_time_us zur tatsächlichen Drehzahl passen; mit Hall-Sensoren gibt
+// der Rotor selbst den Takt vor. Der GPIO-Interrupt liest bei jeder Flanke alle drei Hall-Pins
+// mit einem Zugriff, wählt über HALL_TO_STEP den Schritt und übergibt ihn samt Zeitstempel an
+// den Kommutations-Scheduler (comm_scheduler_hall_edge). Geschaltet wird im Alarm-Interrupt
+// direkt danach: der Bank-0-Interrupt hat die Priorität des Fault-Handlers und darf deshalb
+// keinen Schritt mit Totzeit ausführen. Laständerungen wirken weiterhin im nächsten Sektor.
+//
+// Drehzahl ohne Sperren: der Interrupt schreibt die Messwerte zwischen zwei Erhöhungen
+// von speed_seq (Sequenz-Zähler). Ungerade = Schreiben läuft. Der Leser kopiert und prüft,
+// ob speed_seq vorher und nachher gleich und gerade war, sonst liest er erneut.
+
+#include "hall.h"
+#include "comm_sched.h"
+#include "config.h"
+
+#define HALL_MASK ((1u << HALL_PIN_A) | (1u << HALL_PIN_B) | (1u << HALL_PIN_C))
+
+static const uint HALL_PIN[3] = {HALL_PIN_A, HALL_PIN_B, HALL_PIN_C};
+static const uint8_t HALL_CODE_OF_STEP[6] = HALL_SEQUENCE;
+static int8_t HALL_TO_STEP[8]; // Hall-Code -> Schritt, -1 = ungültig (wird in hall_init gefüllt)
+
+static volatile bool hall_running = false; // Kommutation aktiv?
+
+static volatile uint32_t speed_seq; // gerade = Daten konsistent
+static volatile hall_speed_t speed; // nur der Interrupt schreibt
+
+// Hall-Code A | B<<1 | C<<2 aus einem einzigen Lesezugriff
+static inline uint hall_code(void)
+{
+    uint32_t all = hal_gpio_get_all();
+    return ((all >> HALL_PIN_A) & 1u) | (((all >> HALL_PIN_B) & 1u) << 1) | (((all >> HALL_PIN_C) & 1u) << 2);
+}
+
+// GPIO-Interrupt: Flanke an einem Hall-Pin
+static void hall_isr(void)
+{
+    uint32_t now = hal_time_us_32(); // Zeitstempel so früh wie möglich
+    if (!hal_gpio_irq_status(HALL_MASK))
+        return; // Bank-0-Interrupt gilt einem anderen Modul (z. B. Fault)
+    hal_gpio_irq_ack(HALL_MASK);
+
+    int step = HALL_TO_STEP[hall_code()];
+
+    speed_seq++; // ungerade: Update läuft
+    if (step < 0)
+    {
+        speed.invalid++;
+    }
+    else
+    {
+        if (speed.edges > 0)
+            speed.period_us = now - speed.last_edge_us;
+        speed.last_edge_us = now;
+        speed.edges++;
+    }
+    speed_seq++; // gerade: Update fertig
+
+    if (step >= 0 && hall_running)
+        comm_scheduler_hall_edge(MAIN_MOTOR, step, now); // schaltet der Alarm-Interrupt
+}
+
+void hall_init(void)
+{
+    for (int c = 0; c < 8; ++c)
+        HALL_TO_STEP[c] = -1;
+    for (int s = 0; s < 6; ++s)
+        HALL_TO_STEP[HALL_CODE_OF_STEP[s]] = (int8_t)s;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        hal_gpio_init(HALL_PIN[i]);
+        hal_gpio_set_dir(HALL_PIN[i], GPIO_IN);
+        hal_gpio_pull_up(HALL_PIN[i]); // Open-Collector-Ausgänge der Sensoren
+    }
+    hal_gpio_irq_init(HALL_MASK, hall_isr, HALL_IRQ_ORDER);
+}
+
+bool hall_present(void)
+{
+    return HALL_TO_STEP[hall_code()] >= 0;
+}
+
+int hall_step(void)
+{
+    return HALL_TO_STEP[hall_code()];
+}
+
+void hall_start(uint16_t pwm_level)
+{
+    comm_scheduler_start_hall(MAIN_MOTOR, pwm_level);
+    hall_running = true;
+
+    // Stillstand: es kommt keine Flanke, also den Schritt zur aktuellen Lage selbst melden
+    int step = HALL_TO_STEP[hall_code()];
+    if (step >= 0)
+        comm_scheduler_hall_edge(MAIN_MOTOR, step, hal_time_us_32());
+}
+
+void hall_stop(void)
+{
+    if (!hall_running)
+        return;
+    hall_running = false;
+    comm_scheduler_stop(MAIN_MOTOR);
+}
+
+void hall_set_level(uint16_t pwm_level)
+{
+    comm_scheduler_set_level(MAIN_MOTOR, pwm_level);
+}
+
+void hall_get_speed(hall_speed_t *out)
+{
+    uint32_t seq;
+    do
+    {
+        seq = speed_seq;
+        out->period_us = speed.period_us;
+        out->last_edge_us = speed.last_edge_us;
+        out->edges = speed.edges;
+        out->invalid = speed.invalid;
+    } while ((seq & 1u) || seq != speed_seq);
+}
+
+uint32_t hall_rpm(void)
+{
+    hall_speed_t s;
+    hall_get_speed(&s);
+    if (s.period_us == 0 || hal_time_us_32() - s.last_edge_us > HALL_TIMEOUT_US)
+        return 0;
+    // 1 Umdrehung = 6 Sektoren je Polpaar
+    return 60000000u / (6u * MOTOR_POLE_PAIRS * s.period_us);
+}
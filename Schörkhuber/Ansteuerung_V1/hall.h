@@ -0,0 +1,47 @@
+// hall.h
+// Hall-Sensor-Betrieb: jede Flanke eines der drei Hall-Signale löst einen GPIO-Interrupt aus,
+// der den Zeitstempel der Flanke erfasst und den passenden COMMUTATION-Schritt dem
+// Kommutations-Scheduler meldet; der schaltet ihn sofort danach im Alarm-Interrupt (comm_sched.h).
+// Aus dem Abstand zweier Flanken (ein Sektor = 60° el.) ergibt sich die aktuelle Drehzahl.
+
+#ifndef HALL_H
+#define HALL_H
+
+#include "hal.h"
+
+// Momentaufnahme der Drehzahlmessung
+typedef struct
+{
+    uint32_t period_us;    // Dauer des letzten Sektors (60° el.), 0 = noch keine Messung
+    uint32_t last_edge_us; // Zeitstempel der letzten Flanke (timerawl)
+    uint32_t edges;        // Anzahl Flanken seit hall_init
+    uint32_t invalid;      // ungültige Hall-Codes (0 oder 7: Sensor/Kabel defekt)
+} hall_speed_t;
+
+// Pins einrichten und Flanken-Interrupt registrieren (Kommutation noch aus)
+void hall_init(void);
+
+// true, wenn ein gültiger Hall-Code anliegt (Sensoren angeschlossen)
+bool hall_present(void);
+
+// Schritt zur aktuellen Rotorlage (-1 = ungültiger Hall-Code)
+int hall_step(void);
+
+// Kommutation über die Hall-Flanken starten: der zum aktuellen Code passende Schritt
+// wird sofort geschaltet (Anlauf aus dem Stillstand ohne Open-Loop-Rampe)
+void hall_start(uint16_t pwm_level);
+
+// Kommutation anhalten (auch den Scheduler für MAIN_MOTOR). Ausgänge schaltet der Aufrufer ab.
+void hall_stop(void);
+
+// Duty ändern (wirkt ab der nächsten Flanke)
+void hall_set_level(uint16_t pwm_level);
+
+// Konsistente Kopie der Drehzahlmessung holen, ohne Interrupts zu sperren.
+// Der Interrupt wird nie blockiert; der Leser wiederholt, falls er mitten in ein Update fiel.
+void hall_get_speed(hall_speed_t *out);
+
+// Drehzahl in U/min aus der letzten Sektordauer (0 bei Stillstand/Timeout)
+uint32_t hall_rpm(void);
+
+#endif // HALL_H
@@ -0,0 +1,164 @@
+// bench_commutation.c
+// Mikrobenchmark für den heißen Pfad der Steuerlogik auf dem PC.
+// Misst je Operation: HAL-Aufrufe, geschätzte Registerzugriffe (aus dem Mock),
+// Laufzeit in ns und – falls der Kernel perf-Zähler erlaubt – ausgeführte Instruktionen.
+// Die absoluten Zeiten/Instruktionen gelten für den Host, nicht für den Cortex-M0+;
+// sie dienen als Regressionsbasis (vorher/nachher), die Aufruf- und Registerzahlen
+// sind dagegen direkt auf den RP2040 übertragbar.
+//
+// Aufruf: bldc_bench [Iterationen]
+
+#include "bldc.h"
+#include "buttons.h"
+#include "comm_sched.h"
+#include "config.h"
+
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// -------------------- Instruktionszähler (perf) --------------------
+static int perf_fd = -1;
+
+static void perf_open(void)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    perf_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void perf_start(void)
+{
+    if (perf_fd < 0)
+        return;
+    ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+// Liefert -1, wenn keine perf-Zähler verfügbar sind (Container, VM, paranoid-Einstellung)
+static long long perf_stop(void)
+{
+    if (perf_fd < 0)
+        return -1;
+    ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long value = 0;
+    if (read(perf_fd, &value, sizeof(value)) != (ssize_t)sizeof(value))
+        return -1;
+    return value;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// -------------------- Messobjekte --------------------
+static int bench_step;
+static volatile bool sink; // verhindert, dass der Compiler reine Abfragen wegoptimiert
+
+static void op_commutate_step(void)
+{
+    commutate_step(MAIN_MOTOR, bench_step, (uint16_t)(PWM_WRAP * 80u / 100u));
+    bench_step = (bench_step + 1) % 6;
+}
+
+static void op_all_off(void) { all_off(MAIN_MOTOR); }
+static void op_is_fault_active(void) { sink = is_fault_active(MAIN_MOTOR); }
+// Hauptschleife ohne Tastendruck: nur ein Blick in den leeren Ereignis-Ring
+static void op_button_idle(void)
+{
+    btn_evt_t evt;
+    sink = button_event_pop(&evt);
+}
+
+// kompletter Scheduler-Schritt: Alarm-ISR inkl. Jitter-Buchhaltung und Neuprogrammierung;
+// der Termin wird auf "jetzt" gelegt, damit jeder Aufruf wirklich kommutiert
+static void op_alarm_isr(void)
+{
+    MAIN_MOTOR->next_at = (uint32_t)mock_now_us();
+    comm_alarm_isr();
+}
+
+typedef struct
+{
+    const char *name;
+    void (*fn)(void);
+} bench_op_t;
+
+static const bench_op_t ops[] = {
+    {"commutate_step", op_commutate_step},
+    {"all_off", op_all_off},
+    {"is_fault_active", op_is_fault_active},
+    {"button_event_pop", op_button_idle},
+    {"comm_alarm_isr", op_alarm_isr},
+};
+
+static void run(const bench_op_t *op, long iterations)
+{
+    mock_reset_counters();
+    uint64_t t0 = now_ns();
+    perf_start();
+    for (long i = 0; i < iterations; ++i)
+        op->fn();
+    long long instr = perf_stop();
+    uint64_t t1 = now_ns();
+
+    double n = (double)iterations;
+    printf("%-26s %9.2f %9.2f %9.2f %9.1f %9.2f ", op->name,
+           (double)mock_total_calls() / n,
+           (double)mock_count.reg_writes / n,
+           (double)mock_count.reg_reads / n,
+           (double)mock_count.busy_wait_us / n,
+           (double)(t1 - t0) / n);
+    if (instr >= 0)
+        printf("%9.1f\n", (double)instr / n);
+    else
+        printf("%9s\n", "n/a");
+}
+
+// Aufschlüsselung der HAL-Aufrufe einer Operation
+static void breakdown(const bench_op_t *op, long iterations)
+{
+    mock_reset_counters();
+    for (long i = 0; i < iterations; ++i)
+        op->fn();
+    printf("\nHAL-Aufrufe je %s:\n", op->name);
+    for (int f = 0; f < MOCK_FN_COUNT; ++f)
+        if (mock_count.calls[f])
+            printf("  %-24s %6.2f\n", mock_fn_name[f], (double)mock_count.calls[f] / (double)iterations);
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = argc > 1 ? strtol(argv[1], NULL, 10) : 200000;
+    if (iterations <= 0)
+        iterations = 200000;
+
+    mock_reset();
+    bldc_init();
+    buttons_init();
+    comm_scheduler_init();
+    comm_scheduler_start(MAIN_MOTOR, (uint16_t)(PWM_WRAP * 80u / 100u));
+    perf_open();
+
+    printf("BLDC Hot-Path Benchmark (%ld Iterationen, Werte je Operation)\n", iterations);
+    printf("%-26s %9s %9s %9s %9s %9s %9s\n", "Operation", "HAL-Calls", "Reg-W", "Reg-R", "Wait-us", "ns(host)", "Instr");
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); ++i)
+        run(&ops[i], iterations);
+
+    breakdown(&ops[0], 6000); // commutate_step über volle elektrische Umdrehungen
+    return 0;
+}
@@ -0,0 +1,416 @@
+// bldc_sim.c
+// Geschlossener Regelkreis auf dem PC: die unveränderte Steuerlogik (control.c mit allen
+// Interrupts aus dem HAL-Mock) treibt das Motormodell aus motor_sim.c, das Modell liefert
+// Hall-Pegel und ADC-Werte zurück. Damit lassen sich Lastprofile nachspielen und die
+// Betriebsarten (Open-Loop, Sensorless + PI, Hall + PI, Sinus) ohne Hardware vergleichen.
+//
+// Jede Betriebsart läuft in einem eigenen Kindprozess (frischer Zustand aller statischen Module)
+// und liefert eine Zeile: mittlere Drehzahl, RMS-Drehzahlfehler und Wirkungsgrad
+// (Lastleistung / Klemmenleistung) über die Zeit nach dem Anlauf + Einschwingzeit.
+//
+// Aufruf: bldc_sim [-s openloop|sensorless|hall|sine|all] [-t Sekunden] [-r U/min]
+//                  [-l Lastprofil] [-w Einschwingzeit s] [-d Zeitschritt µs] [-c trace.csv] [-v]
+// Lastprofil: je Zeile "t_s last_Nm soll_rpm" (Leerzeichen oder Komma, '#' = Kommentar),
+// stückweise konstant ab t_s; ohne Profil konstant 2 mNm. Die Solldrehzahlen des Profils gehen nach
+// dem Anlauf als Trajektorie (traj.h) in einem Rutsch an die Steuerung, der Rest wird nachgeschoben.
+
+#include "bldc.h"
+#include "comm_sched.h"
+#include "config.h"
+#include "control.h"
+#include "dlog.h"
+#include "fault.h"
+#include "motor_sim.h"
+#include "pwm_engine.h"
+#include "traj.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PROFILE_MAX 256
+#define POLL_US 1000u // control_poll wie die core1-Schleife, Auswertung im selben Raster
+
+typedef enum
+{
+    STRAT_OPENLOOP,
+    STRAT_SENSORLESS,
+    STRAT_HALL,
+    STRAT_SINE,
+    STRAT_COUNT
+} strategy_t;
+
+static const char *const STRAT_NAME[STRAT_COUNT] = {"openloop", "sensorless", "hall", "sine"};
+
+typedef struct
+{
+    double t_s;
+    double load_nm;
+    double target_rpm;
+} profile_point_t;
+
+typedef struct
+{
+    double sim_s;      // simulierte Zeit
+    double warmup_s;   // Einschwingzeit nach dem Anlauf (ohne Auswertung)
+    double dt_us;      // Integrationsschritt des Modells
+    double target_rpm; // ohne Profil
+    bool verbose;      // DLOG-Meldungen der Steuerung ausgeben
+    FILE *trace;       // CSV je ms (optional)
+    profile_point_t profile[PROFILE_MAX];
+    int profile_len;
+} sim_opts_t;
+
+// -------------------- Lastprofil --------------------
+static bool load_profile(const char *path, sim_opts_t *o)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    int lineno = 0;
+    o->profile_len = 0;
+    while (fgets(line, sizeof(line), f))
+    {
+        lineno++;
+        char *hash = strchr(line, '#');
+        if (hash)
+            *hash = '\0';
+        for (char *c = line; *c; ++c)
+            if (*c == ',')
+                *c = ' ';
+        profile_point_t pt;
+        int n = sscanf(line, "%lf %lf %lf", &pt.t_s, &pt.load_nm, &pt.target_rpm);
+        if (n <= 0)
+            continue; // Leer- oder Kommentarzeile
+        if (n != 3 || o->profile_len == PROFILE_MAX)
+        {
+            fprintf(stderr, "%s:%d: expected \"t_s load_Nm target_rpm\" (max %d lines)\n", path, lineno, PROFILE_MAX);
+            fclose(f);
+            return false;
+        }
+        o->profile[o->profile_len++] = pt;
+    }
+    fclose(f);
+    return o->profile_len > 0;
+}
+
+// Profilpunkt zum Zeitpunkt t (stückweise konstant, vor dem ersten Punkt gilt der erste)
+static const profile_point_t *profile_at(const sim_opts_t *o, double t_s)
+{
+    int k = 0;
+    while (k + 1 < o->profile_len && o->profile[k + 1].t_s <= t_s)
+        k++;
+    return &o->profile[k];
+}
+
+// Solldrehzahlen des Profils als Trajektorie, Zeitnullpunkt = t_start (frühere Punkte gelten sofort)
+static int profile_to_traj(const sim_opts_t *o, double t_start, traj_point_t *out)
+{
+    for (int k = 0; k < o->profile_len; ++k)
+    {
+        double t = o->profile[k].t_s - t_start;
+        out[k].t_ms = t > 0 ? (uint32_t)(t * 1000.0 + 0.5) : 0;
+        out[k].value = (uint32_t)o->profile[k].target_rpm;
+        out[k].kind = TRAJ_SPEED;
+    }
+    return o->profile_len;
+}
+
+// -------------------- Ein Lauf --------------------
+typedef struct
+{
+    double t0_s;    // Beginn der Auswertung
+    double n;       // Abtastwerte (je ms)
+    double rpm_sum; // Summe der Drehzahlen
+    double err_sq;  // Summe (ist - soll)^2
+    double e_mech;  // Lastarbeit (J)
+    double e_in;    // Klemmenenergie (J)
+    double omega0;  // Drehzahl zu Beginn der Auswertung (Änderung der Rotationsenergie)
+    bool ramp_done; // Anlauf abgeschlossen (Sollwert übergeben)
+} run_stats_t;
+
+// Open-Loop-Schrittdauer für eine Drehzahl, begrenzt wie in control.c
+static uint32_t step_time_for(double rpm)
+{
+    double t = 60e6 / (6.0 * MOTOR_POLE_PAIRS * (rpm > 1.0 ? rpm : 1.0));
+    if (t < STEP_TIME_MIN_US)
+        t = STEP_TIME_MIN_US;
+    if (t > STEP_TIME_MAX_US)
+        t = STEP_TIME_MAX_US;
+    return (uint32_t)t;
+}
+
+// Sollwert an die Steuerung: geregelte Betriebsarten bekommen die Drehzahl, Open-Loop/Sinus die Schrittdauer
+static void send_target(strategy_t s, double rpm)
+{
+    if (s == STRAT_OPENLOOP || s == STRAT_SINE)
+        control_send(CTRL_CMD_SET_STEP_TIME, step_time_for(rpm));
+    else
+        control_send(CTRL_CMD_SET_TARGET, (uint32_t)rpm);
+}
+
+// Anlauf je Betriebsart, einmal je ms. Open-Loop/Sinus/Sensorless bekommen einmal die
+// Ziel-Schrittdauer, hochfahren tut die Rampe der Steuerung (ramp.c, RAMP_ACCEL). Sensorless ist
+// fertig, sobald der Scheduler auf Gegen-EMK umgeschaltet hat (nach Sync-Verlust rampt der Scheduler
+// selbst erneut), die anderen bei erreichter Schrittdauer.
+static bool ramp(strategy_t s, double target_rpm, bool *sent)
+{
+    if (s == STRAT_HALL)
+        return true;
+    if (!*sent)
+    {
+        control_send(CTRL_CMD_SET_STEP_TIME, step_time_for(target_rpm));
+        *sent = true;
+    }
+    if (s == STRAT_SENSORLESS)
+        return comm_scheduler_mode(MAIN_MOTOR) == COMM_SENSORLESS;
+    return MAIN_MOTOR->step_time_us <= step_time_for(target_rpm);
+}
+
+static void trace_row(FILE *f, strategy_t s, double t_s, const motor_sim_t *m, double load, double target)
+{
+    fprintf(f, "%s,%.3f,%.1f,%.1f,%.5f,%.5f,%.3f,%.3f,%.3f,%.2f,%u,%u\n", STRAT_NAME[s], t_s, motor_sim_rpm(m),
+            target, m->torque, load, m->i[0], m->i[1], m->i[2], m->p_in, (unsigned)comm_scheduler_mode(MAIN_MOTOR),
+            (unsigned)MAIN_MOTOR->step_time_us);
+}
+
+static void run(strategy_t s, const sim_opts_t *o)
+{
+    motor_params_t params;
+    motor_sim_default_params(&params);
+    params.hall = (s == STRAT_HALL);
+
+    mock_reset();
+    motor_sim_t m;
+    motor_sim_init(&m, &params); // Hall-Pegel vor control_init -> hall_present()
+    control_init();
+    fault_stats_t fs0;
+    fault_get_stats(&fs0); // Selbsttest nicht mitzählen
+
+    if (s == STRAT_OPENLOOP || s == STRAT_SINE)
+        comm_scheduler_enable_sensorless(false);
+    if (s == STRAT_SINE)
+        control_send(CTRL_CMD_SET_DRIVE_MODE, 1);
+
+    struct timespec w0, w1;
+    clock_gettime(CLOCK_MONOTONIC, &w0);
+
+    const double dt = o->dt_us * 1e-6;
+    const uint64_t end_us = mock_now_us() + (uint64_t)(o->sim_s * 1e6);
+    const uint64_t start_us = mock_now_us();
+    double sim_us = (double)start_us; // Modellzeit (Bruchteile von µs bei dt < 1)
+    double next_wrap = (double)start_us;
+    uint64_t next_poll = start_us;
+    bool ramp_sent = false;
+    traj_point_t traj[PROFILE_MAX];
+    int traj_len = 0, traj_sent = 0; // Trajektorie: Punkte gesamt / schon im Ring
+    double target = o->target_rpm;
+    bool ready = false; // Anlauf fertig, Sollwert übergeben
+    run_stats_t st = {0};
+
+    while (mock_now_us() < end_us)
+    {
+        uint32_t adv = (uint32_t)ceil(sim_us + o->dt_us - (double)mock_now_us());
+        mock_advance_us(adv > 0 ? adv : 1u);
+        double t_s = (double)(mock_now_us() - start_us) * 1e-6;
+        const profile_point_t *pt = o->profile_len ? profile_at(o, t_s) : 0;
+        double load = pt ? pt->load_nm : 0.002;
+
+        // Modell bis zur Mock-Zeit nachziehen, PWM-Wraps (Strommessung, Sinus) dazwischen
+        while (sim_us + o->dt_us <= (double)mock_now_us() + 1e-9)
+        {
+            motor_sim_step(&m, dt, load);
+            sim_us += o->dt_us;
+            if (sim_us >= next_wrap)
+            {
+                mock_pwm_wrap();
+                next_wrap += 1e9 / (double)pwm_engine_timing()->freq_mhz;
+            }
+            if (st.n > 0)
+            {
+                double w = m.omega > 0 ? m.omega : 0;
+                st.e_mech += load * w * dt;
+                st.e_in += m.p_in * dt;
+            }
+        }
+
+        if (mock_now_us() < next_poll)
+            continue;
+        next_poll += POLL_US;
+        control_poll();
+        if (o->verbose)
+            dlog_flush();
+
+        // Sensorless fällt bei Sync-Verlust auf den Open-Loop-Anlauf zurück (der Scheduler rampt erneut) -> nach
+        // der neuen Übergabe den Sollwert wieder setzen (der Regler übernimmt die erreichte Drehzahl)
+        double want = pt ? pt->target_rpm : o->target_rpm;
+        bool was_ready = ready;
+        if (!st.ramp_done || s == STRAT_SENSORLESS)
+            ready = ramp(s, want, &ramp_sent);
+        if (ready && !was_ready)
+        {
+            if (!st.ramp_done && o->profile_len)
+            {
+                // weitere Sollwerte des Profils laufen ab jetzt termingerecht in der Steuerung
+                traj_len = profile_to_traj(o, t_s, traj);
+                traj_sent = (int)traj_push(traj, (uint)traj_len);
+                control_send(CTRL_CMD_TRAJ_START, 0);
+            }
+            if (!st.ramp_done)
+                st.t0_s = t_s + o->warmup_s;
+            st.ramp_done = true;
+            send_target(s, want);
+        }
+        if (traj_sent < traj_len)
+            traj_sent += (int)traj_push(&traj[traj_sent], (uint)(traj_len - traj_sent)); // nachschieben
+        if (st.ramp_done)
+            target = want;
+
+        if (st.ramp_done && t_s >= st.t0_s)
+        {
+            double rpm = motor_sim_rpm(&m);
+            if (st.n == 0)
+                st.omega0 = m.omega;
+            st.n++;
+            st.rpm_sum += rpm;
+            st.err_sq += (rpm - target) * (rpm - target);
+        }
+        if (o->trace)
+            trace_row(o->trace, s, t_s, &m, load, st.ramp_done ? target : 0);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &w1);
+    fault_stats_t fs;
+    fault_get_stats(&fs);
+    double wall = (double)(w1.tv_sec - w0.tv_sec) + (double)(w1.tv_nsec - w0.tv_nsec) * 1e-9;
+    // Wirkungsgrad: Lastarbeit + Zuwachs an Rotationsenergie je Klemmenenergie
+    double e_out = st.e_mech + 0.5 * m.p.j_kgm2 * (m.omega * m.omega - st.omega0 * st.omega0);
+    if (st.n > 0)
+        printf("%-10s %8.1f %8.2f %8.0f %9.0f %9.1f %7.1f %8llu %6u\n", STRAT_NAME[s], o->sim_s, wall, target,
+               st.rpm_sum / st.n, sqrt(st.err_sq / st.n), st.e_in > 0 ? 100.0 * e_out / st.e_in : 0.0,
+               (unsigned long long)m.shoot, fs.count - fs0.count);
+    else
+        printf("%-10s %8.1f %8.2f %8.0f %9s %9s %7s %8llu %6u  (start-up not finished)\n", STRAT_NAME[s], o->sim_s,
+               wall, target, "-", "-", "-", (unsigned long long)m.shoot, fs.count - fs0.count);
+    if (o->verbose)
+        dlog_flush();
+    fflush(stdout);
+    if (o->trace)
+        fflush(o->trace);
+}
+
+// -------------------- Hauptprogramm --------------------
+static void usage(void)
+{
+    fprintf(stderr, "usage: bldc_sim [-s openloop|sensorless|hall|sine|all] [-t seconds] [-r rpm]\n"
+                    "                [-l profile] [-w warmup_s] [-d dt_us] [-c trace.csv] [-v]\n");
+}
+
+int main(int argc, char **argv)
+{
+    sim_opts_t o = {.sim_s = 10.0, .warmup_s = 2.0, .dt_us = 2.0, .target_rpm = 3000.0};
+    const char *strat = "all";
+    const char *trace = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:t:r:l:w:d:c:v")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            strat = optarg;
+            break;
+        case 't':
+            o.sim_s = atof(optarg);
+            break;
+        case 'r':
+            o.target_rpm = atof(optarg);
+            break;
+        case 'l':
+            if (!load_profile(optarg, &o))
+                return 1;
+            break;
+        case 'w':
+            o.warmup_s = atof(optarg);
+            break;
+        case 'd':
+            o.dt_us = atof(optarg);
+            break;
+        case 'c':
+            trace = optarg;
+            break;
+        case 'v':
+            o.verbose = true;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+    if (o.sim_s <= 0 || o.dt_us <= 0 || o.dt_us > 20.0)
+    {
+        fprintf(stderr, "need -t > 0 and 0 < -d <= 20 us (BEMF sampling every %u us)\n", BEMF_POLL_US);
+        return 1;
+    }
+
+    bool run_it[STRAT_COUNT] = {false};
+    bool any = false;
+    for (int s = 0; s < STRAT_COUNT; ++s)
+        any |= run_it[s] = !strcmp(strat, "all") || !strcmp(strat, STRAT_NAME[s]);
+    if (!any)
+    {
+        usage();
+        return 1;
+    }
+    if (trace)
+    {
+        if (!(o.trace = fopen(trace, "w")))
+        {
+            perror(trace);
+            return 1;
+        }
+        fprintf(o.trace, "strategy,t_s,rpm,target_rpm,torque_nm,load_nm,i_a,i_b,i_c,p_in_w,mode,step_time_us\n");
+    }
+
+    printf("%-10s %8s %8s %8s %9s %9s %7s %8s %6s\n", "strategy", "sim_s", "wall_s", "target", "mean_rpm",
+           "rpm_rms", "eff_%", "shoot", "faults");
+    fflush(stdout);
+    if (o.trace)
+        fflush(o.trace);
+
+    // nacheinander in Kindprozessen: frischer statischer Zustand je Lauf, Trace-Zeilen nicht verschachtelt
+    int rc = 0;
+    for (int s = 0; s < STRAT_COUNT; ++s)
+    {
+        if (!run_it[s])
+            continue;
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+        if (pid == 0)
+        {
+            run((strategy_t)s, &o);
+            _exit(0);
+        }
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            fprintf(stderr, "%s: run aborted\n", STRAT_NAME[s]);
+            rc = 1;
+        }
+    }
+    if (o.trace)
+        fclose(o.trace);
+    return rc;
+}
@@ -0,0 +1,637 @@
+// hal_mock.c
+// Aufzeichnender Mock der HAL für den Host-Build.
+// Registerzugriffe werden so gezählt, wie das Pico-SDK sie auf dem RP2040 ausführt
+// (z. B. gpio_set_function = Pad-Register + IO-CTRL-Register = 2 Schreibzugriffe),
+// damit die Zahlen als Regressionsbasis für Optimierungen der Steuerlogik taugen.
+
+#include "hal_mock.h"
+
+#include <string.h>
+
+const char *const mock_fn_name[MOCK_FN_COUNT] = {
+    "gpio_init",
+    "gpio_set_function",
+    "gpio_set_dir",
+    "gpio_put",
+    "gpio_get",
+    "gpio_pull_*",
+    "gpio_set_dir_masked",
+    "gpio_set_oeover",
+    "gpio_irq_*",
+    "irq save/restore",
+    "pwm_gpio_to_slice_num",
+    "pwm_gpio_to_channel",
+    "pwm_set_wrap",
+    "pwm_set_clkdiv_int_frac",
+    "pwm_set_chan_level",
+    "pwm_set_enabled",
+    "pwm_set_mask_enabled",
+    "pwm_phase/counter/intr",
+    "clock_get_hz",
+    "time read",
+    "cycles",
+    "busy_wait_us",
+    "sleep_ms",
+    "alarm_*",
+    "adc_stream_start",
+    "uart_dma_*",
+};
+
+mock_counters_t mock_count;
+mock_pin_t mock_pin[MOCK_NUM_GPIO];
+mock_slice_t mock_slice[MOCK_NUM_PWM_SLICES];
+
+static uint64_t now_us;                          // simulierte Zeit
+static irq_handler_t alarm_isr[MOCK_NUM_ALARMS]; // registrierte Alarm-Handler
+static uint32_t alarm_target[MOCK_NUM_ALARMS];   // programmierter Termin (untere 32 bit)
+static bool alarm_armed[MOCK_NUM_ALARMS];        // Alarm scharf?
+static bool alarm_irq_enabled[MOCK_NUM_ALARMS];  // Interrupt freigegeben?
+static bool alarm_pended[MOCK_NUM_ALARMS];       // per hal_alarm_pend angestoßen, noch nicht gelaufen
+static int isr_depth;                            // > 0: ein Handler läuft gerade
+static uint32_t gpio_irq_rise;                   // Pins mit Interrupt auf steigende Flanke
+static uint32_t gpio_irq_fall;                   // Pins mit Interrupt auf fallende Flanke
+static uint32_t gpio_irq_pending;                // noch nicht quittierte Flanken
+static uint32_t gpio_irq_forced;                 // per INTF erzwungene Interrupts
+static struct
+{
+    uint32_t mask;
+    irq_handler_t isr;
+} gpio_handler[MOCK_NUM_GPIO_HANDLERS];   // Raw-Handler wie gpio_add_raw_irq_handler_masked
+static volatile uint16_t *adc_buf;        // Ziel des ADC-Streams (wie DMA)
+static uint adc_inputs;                   // Anzahl Eingänge im Stream
+static struct
+{
+    uint slice;
+    irq_handler_t isr;
+} wrap_handler[MOCK_NUM_WRAP_HANDLERS]; // Wrap-Handler (hal_pwm_wrap_irq_init)
+static uint32_t wrap_irq_enabled;         // Slices mit freigegebenem Wrap-Interrupt
+static const volatile uint16_t *wrap_src; // DMA-Quelle je Wrap
+static volatile uint16_t *wrap_ring;      // DMA-Ring
+static uint32_t wrap_ring_mask;           // Ringgröße in Byte - 1
+static uint32_t wrap_pos;                 // nächste Schreibposition (Byte)
+static uint8_t uart_tx[MOCK_UART_TX_MAX]; // per UART-DMA gesendete, noch nicht abgeholte Bytes
+static size_t uart_tx_len;
+
+// Einen HAL-Aufruf mit seinen Registerzugriffen verbuchen
+static inline void count(mock_fn_t fn, unsigned writes, unsigned reads)
+{
+    mock_count.calls[fn]++;
+    mock_count.reg_writes += writes;
+    mock_count.reg_reads += reads;
+}
+
+void mock_reset_counters(void)
+{
+    memset(&mock_count, 0, sizeof(mock_count));
+}
+
+void mock_reset(void)
+{
+    mock_reset_counters();
+    for (uint i = 0; i < MOCK_NUM_GPIO; ++i)
+    {
+        mock_pin[i].fn = GPIO_FUNC_NULL;
+        mock_pin[i].dir_out = false;
+        mock_pin[i].out = false;
+        mock_pin[i].ext_level = false;
+        mock_pin[i].ext_driven = false;
+        mock_pin[i].oeover = GPIO_OVERRIDE_NORMAL;
+    }
+    memset(mock_slice, 0, sizeof(mock_slice));
+    for (uint i = 0; i < MOCK_NUM_ALARMS; ++i)
+    {
+        alarm_isr[i] = 0;
+        alarm_armed[i] = false;
+        alarm_irq_enabled[i] = false;
+        alarm_pended[i] = false;
+    }
+    isr_depth = 0;
+    gpio_irq_rise = 0;
+    gpio_irq_fall = 0;
+    gpio_irq_pending = 0;
+    gpio_irq_forced = 0;
+    memset(gpio_handler, 0, sizeof(gpio_handler));
+    adc_buf = 0;
+    adc_inputs = 0;
+    uart_tx_len = 0;
+    memset(wrap_handler, 0, sizeof(wrap_handler));
+    wrap_irq_enabled = 0;
+    wrap_src = 0;
+    wrap_ring = 0;
+    wrap_pos = 0;
+    now_us = 0;
+}
+
+uint64_t mock_total_calls(void)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < MOCK_FN_COUNT; ++i)
+        sum += mock_count.calls[i];
+    return sum;
+}
+
+// Angestoßene Alarm-Interrupts ausführen, sobald kein Handler mehr läuft (wie das NVIC nach
+// dem Rücksprung aus dem auslösenden Interrupt)
+static void run_pended(void)
+{
+    if (isr_depth > 0)
+        return;
+    for (int i = 0; i < MOCK_NUM_ALARMS; ++i)
+        if (alarm_pended[i] && alarm_irq_enabled[i] && alarm_isr[i])
+        {
+            alarm_pended[i] = false;
+            isr_depth++;
+            alarm_isr[i]();
+            isr_depth--;
+        }
+}
+
+// Bank-0-Interrupt: wie in der Hardware laufen alle Raw-Handler (in Registrierreihenfolge),
+// jeder prüft selbst, ob seine Pins betroffen sind
+static void gpio_dispatch(void)
+{
+    isr_depth++;
+    for (int i = 0; i < MOCK_NUM_GPIO_HANDLERS; ++i)
+        if (gpio_handler[i].isr)
+            gpio_handler[i].isr();
+    isr_depth--;
+    run_pended();
+}
+
+void mock_set_input(uint pin, bool level)
+{
+    bool edge = mock_pin[pin].ext_level != level;
+    mock_pin[pin].ext_level = level;
+    mock_pin[pin].ext_driven = true;
+    if (!edge || !((level ? gpio_irq_rise : gpio_irq_fall) & (1u << pin)))
+        return;
+    gpio_irq_pending |= 1u << pin;
+    gpio_dispatch();
+}
+
+void mock_set_adc(uint input, uint16_t value)
+{
+    if (adc_buf && input < adc_inputs)
+        adc_buf[input] = value;
+}
+
+void mock_pwm_wrap(void)
+{
+    if (wrap_src)
+    {
+        wrap_ring[wrap_pos / 2u] = *wrap_src;
+        wrap_pos = (wrap_pos + 2u) & wrap_ring_mask;
+    }
+    isr_depth++;
+    for (int i = 0; i < MOCK_NUM_WRAP_HANDLERS; ++i)
+        if (wrap_handler[i].isr && (wrap_irq_enabled & (1u << wrap_handler[i].slice)))
+            wrap_handler[i].isr();
+    isr_depth--;
+    run_pended();
+}
+
+size_t mock_uart_take(uint8_t *out, size_t max)
+{
+    size_t n = uart_tx_len < max ? uart_tx_len : max;
+    memcpy(out, uart_tx, n);
+    memmove(uart_tx, uart_tx + n, uart_tx_len - n);
+    uart_tx_len -= n;
+    return n;
+}
+
+uint64_t mock_now_us(void)
+{
+    return now_us;
+}
+
+// Zeit fortschreiben; fällige Alarme werden in zeitlicher Reihenfolge ausgelöst
+void mock_advance_us(uint32_t us)
+{
+    uint64_t end = now_us + us;
+    for (;;)
+    {
+        int next = -1;
+        uint64_t next_at = end;
+        for (int i = 0; i < MOCK_NUM_ALARMS; ++i)
+        {
+            if (!alarm_armed[i] || !alarm_irq_enabled[i] || !alarm_isr[i])
+                continue;
+            // Termin relativ zur aktuellen Zeit (32-bit Vergleich wie in der Hardware)
+            uint64_t at = now_us + (uint32_t)(alarm_target[i] - (uint32_t)now_us);
+            if (at <= next_at)
+            {
+                next = i;
+                next_at = at;
+            }
+        }
+        if (next < 0)
+            break;
+        now_us = next_at;
+        alarm_armed[next] = false; // Hardware entschärft den Alarm beim Auslösen
+        isr_depth++;
+        alarm_isr[next]();
+        isr_depth--;
+        run_pended();
+    }
+    if (end > now_us)
+        now_us = end;
+}
+
+// -------------------- GPIO --------------------
+void hal_gpio_init(uint pin)
+{
+    count(MOCK_GPIO_INIT, 4, 0); // SIO oe_clr, out_clr, Pad, IO-CTRL
+    mock_pin[pin].fn = GPIO_FUNC_SIO;
+    mock_pin[pin].dir_out = false;
+    mock_pin[pin].out = false;
+}
+
+void hal_gpio_set_function(uint pin, enum gpio_function fn)
+{
+    count(MOCK_GPIO_SET_FUNCTION, 2, 0); // Pad (IE/OD) + IO-CTRL
+    mock_pin[pin].fn = fn;
+}
+
+void hal_gpio_set_dir(uint pin, bool out)
+{
+    count(MOCK_GPIO_SET_DIR, 1, 0); // SIO oe_set / oe_clr
+    mock_pin[pin].dir_out = out;
+}
+
+void hal_gpio_put(uint pin, bool value)
+{
+    count(MOCK_GPIO_PUT, 1, 0); // SIO out_set / out_clr
+    mock_pin[pin].out = value;
+}
+
+bool hal_gpio_get(uint pin)
+{
+    count(MOCK_GPIO_GET, 0, 1); // SIO gpio_in
+    const mock_pin_t *p = &mock_pin[pin];
+    if (p->fn == GPIO_FUNC_SIO && p->dir_out)
+        return p->out;
+    return p->ext_level;
+}
+
+void hal_gpio_pull_up(uint pin)
+{
+    count(MOCK_GPIO_PULL, 1, 0); // Pad-Register (hw_write_masked)
+    if (!mock_pin[pin].ext_driven)
+        mock_pin[pin].ext_level = true; // ein von außen getriebener Pegel ist stärker als der Pull
+}
+
+void hal_gpio_pull_down(uint pin)
+{
+    count(MOCK_GPIO_PULL, 1, 0);
+    if (!mock_pin[pin].ext_driven)
+        mock_pin[pin].ext_level = false;
+}
+
+void hal_gpio_disable_pulls(uint pin)
+{
+    count(MOCK_GPIO_PULL, 1, 0);
+    (void)pin;
+}
+
+uint32_t hal_gpio_get_all(void)
+{
+    count(MOCK_GPIO_GET, 0, 1); // SIO gpio_in
+    uint32_t all = 0;
+    for (uint i = 0; i < MOCK_NUM_GPIO; ++i)
+    {
+        const mock_pin_t *p = &mock_pin[i];
+        bool level = (p->fn == GPIO_FUNC_SIO && p->dir_out) ? p->out : p->ext_level;
+        all |= (uint32_t)level << i;
+    }
+    return all;
+}
+
+void hal_gpio_set_dir_in_masked(uint32_t mask)
+{
+    count(MOCK_GPIO_SET_DIR_MASKED, 1, 0); // gpio_oe_clr
+    for (uint32_t m = mask; m; m &= m - 1u)
+        mock_pin[__builtin_ctz(m)].dir_out = false;
+}
+
+// order wird ignoriert: Handler laufen in Registrierreihenfolge
+void hal_gpio_irq_init(uint32_t mask, irq_handler_t isr, uint8_t order)
+{
+    (void)order;
+    count(MOCK_GPIO_IRQ, 2 + (unsigned)__builtin_popcount(mask), 0); // Handler, INTE je Pin, NVIC
+    for (int i = 0; i < MOCK_NUM_GPIO_HANDLERS; ++i)
+        if (!gpio_handler[i].isr)
+        {
+            gpio_handler[i].mask = mask;
+            gpio_handler[i].isr = isr;
+            break;
+        }
+    gpio_irq_rise |= mask;
+    gpio_irq_fall |= mask;
+}
+
+void hal_gpio_irq_set_edges(uint pin, bool rise, bool fall)
+{
+    count(MOCK_GPIO_IRQ, 2, 0); // INTE löschen + setzen
+    gpio_irq_rise = rise ? gpio_irq_rise | (1u << pin) : gpio_irq_rise & ~(1u << pin);
+    gpio_irq_fall = fall ? gpio_irq_fall | (1u << pin) : gpio_irq_fall & ~(1u << pin);
+}
+
+void hal_gpio_irq_set_priority(uint8_t priority)
+{
+    count(MOCK_GPIO_IRQ, 1, 0); // NVIC IPR
+    (void)priority;
+}
+
+uint32_t hal_gpio_irq_status(uint32_t mask)
+{
+    count(MOCK_GPIO_IRQ, 0, 1); // INTS (ein Register je 8 Pins, hier genähert)
+    return (gpio_irq_pending | gpio_irq_forced) & mask;
+}
+
+void hal_gpio_irq_ack(uint32_t mask)
+{
+    count(MOCK_GPIO_IRQ, (unsigned)__builtin_popcount(mask), 0); // INTR je Pin
+    gpio_irq_pending &= ~mask;
+}
+
+void hal_gpio_irq_force(uint pin, bool force)
+{
+    count(MOCK_GPIO_IRQ, 1, 0); // INTF
+    if (!force)
+    {
+        gpio_irq_forced &= ~(1u << pin);
+        return;
+    }
+    gpio_irq_forced |= 1u << pin;
+    gpio_dispatch(); // Interrupt kommt sofort
+}
+
+// -------------------- Interrupts --------------------
+// Auf dem Host ohne Wirkung (Handler laufen nur aus mock_advance_us / mock_set_input)
+uint32_t hal_irq_save(void)
+{
+    count(MOCK_IRQ_SAVE_RESTORE, 0, 0);
+    return 0;
+}
+
+void hal_irq_restore(uint32_t state)
+{
+    count(MOCK_IRQ_SAVE_RESTORE, 0, 0);
+    (void)state;
+}
+
+void hal_gpio_set_dir_masked(uint32_t mask, uint32_t value)
+{
+    count(MOCK_GPIO_SET_DIR_MASKED, 1, 1); // gpio_oe lesen, gpio_oe_togl schreiben
+    for (uint32_t m = mask; m; m &= m - 1u)
+    {
+        uint i = (uint)__builtin_ctz(m);
+        mock_pin[i].dir_out = (value >> i) & 1u;
+    }
+}
+
+void hal_gpio_set_oeover(uint pin, uint value)
+{
+    count(MOCK_GPIO_SET_OEOVER, 1, 1); // IO-CTRL read-modify-write (hw_write_masked)
+    mock_pin[pin].oeover = value;
+}
+
+// -------------------- PWM --------------------
+// Zuordnung wie im RP2040: Slice = (gpio >> 1) & 7, Kanal = gpio & 1
+uint hal_pwm_gpio_to_slice_num(uint pin)
+{
+    count(MOCK_PWM_GPIO_TO_SLICE, 0, 0);
+    return (pin >> 1u) & 7u;
+}
+
+uint hal_pwm_gpio_to_channel(uint pin)
+{
+    count(MOCK_PWM_GPIO_TO_CHANNEL, 0, 0);
+    return pin & 1u;
+}
+
+void hal_pwm_set_wrap(uint slice, uint16_t wrap)
+{
+    count(MOCK_PWM_SET_WRAP, 1, 0);
+    mock_slice[slice].wrap = wrap;
+}
+
+void hal_pwm_set_clkdiv_int_frac(uint slice, uint8_t div_int, uint8_t div_frac)
+{
+    count(MOCK_PWM_SET_CLKDIV, 1, 0);
+    mock_slice[slice].div_int = div_int;
+    mock_slice[slice].div_frac = div_frac;
+}
+
+void hal_pwm_set_phase_correct(uint slice, bool phase_correct)
+{
+    count(MOCK_PWM_MISC, 1, 1); // CSR read-modify-write
+    mock_slice[slice].phase_correct = phase_correct;
+}
+
+void hal_pwm_set_counter(uint slice, uint16_t c)
+{
+    count(MOCK_PWM_MISC, 1, 0);
+    mock_slice[slice].counter = c;
+}
+
+void hal_pwm_wrap_clear(uint slice)
+{
+    (void)slice;
+    count(MOCK_PWM_MISC, 1, 0); // INTR (write 1 to clear)
+}
+
+// Der Mock zählt keine PWM-Perioden: ein Wrap gilt als sofort erfolgt
+bool hal_pwm_wrap_pending(uint slice)
+{
+    (void)slice;
+    count(MOCK_PWM_MISC, 0, 1);
+    return true;
+}
+
+void hal_pwm_set_chan_level(uint slice, uint chan, uint16_t level)
+{
+    count(MOCK_PWM_SET_CHAN_LEVEL, 1, 1); // CC-Register read-modify-write (hw_write_masked)
+    mock_slice[slice].level[chan] = level;
+}
+
+void hal_pwm_set_enabled(uint slice, bool enabled)
+{
+    count(MOCK_PWM_SET_ENABLED, 1, 1);
+    mock_slice[slice].enabled = enabled;
+}
+
+void hal_pwm_set_mask_enabled(uint32_t mask)
+{
+    count(MOCK_PWM_SET_MASK_ENABLED, 1, 0); // EN-Register, alle Slices gleichzeitig
+    for (uint i = 0; i < MOCK_NUM_PWM_SLICES; ++i)
+        mock_slice[i].enabled = (mask >> i) & 1u;
+}
+
+uint32_t hal_clock_sys_hz(void)
+{
+    count(MOCK_CLOCK_GET_HZ, 0, 0);
+    return 125000000u; // Standard-Systemtakt RP2040
+}
+
+// -------------------- Zeit --------------------
+uint32_t hal_time_us_32(void)
+{
+    count(MOCK_TIME_READ, 0, 1);
+    return (uint32_t)now_us;
+}
+
+uint32_t hal_time_ms(void)
+{
+    count(MOCK_TIME_READ, 0, 2); // timelr + timehr
+    return (uint32_t)(now_us / 1000u);
+}
+
+// -------------------- Zyklenzähler --------------------
+void hal_cycles_init(void)
+{
+    count(MOCK_CYCLES, 3, 0);
+}
+
+// simulierte Zeit in 125-MHz-Takten (24 bit wie SysTick)
+uint32_t hal_cycles(void)
+{
+    count(MOCK_CYCLES, 0, 1);
+    return (uint32_t)(now_us * 125u) & 0x00ffffffu;
+}
+
+// Busy-Wait verbraucht nur simulierte Zeit (löst keine Alarme aus, wie im Interrupt).
+// Ein Alarm, dessen Termin dabei verstreicht, bleibt wie in der Hardware anhängig und
+// läuft beim nächsten mock_advance_us sofort.
+void hal_busy_wait_us(uint32_t us)
+{
+    count(MOCK_BUSY_WAIT, 0, 2);
+    mock_count.busy_wait_us += us;
+    for (int i = 0; i < MOCK_NUM_ALARMS; ++i)
+        if (alarm_armed[i] && alarm_target[i] - (uint32_t)now_us <= us)
+            alarm_target[i] = (uint32_t)(now_us + us);
+    now_us += us;
+}
+
+void hal_sleep_ms(uint32_t ms)
+{
+    count(MOCK_SLEEP, 0, 0);
+    mock_advance_us(ms * 1000u);
+}
+
+// -------------------- Alarm --------------------
+void hal_alarm_init(uint alarm, irq_handler_t isr, uint8_t priority)
+{
+    count(MOCK_ALARM, 2, 0); // INTE + NVIC
+    alarm_isr[alarm] = isr;
+    alarm_irq_enabled[alarm] = true;
+    (void)priority; // Host: Alarme laufen nacheinander in Terminreihenfolge
+}
+
+void hal_alarm_arm(uint alarm, uint32_t target_us)
+{
+    count(MOCK_ALARM, 1, 0);
+    alarm_target[alarm] = target_us;
+    alarm_armed[alarm] = true;
+}
+
+void hal_alarm_disarm(uint alarm)
+{
+    count(MOCK_ALARM, 1, 0);
+    alarm_armed[alarm] = false;
+}
+
+void hal_alarm_ack(uint alarm)
+{
+    count(MOCK_ALARM, 1, 0);
+    (void)alarm;
+}
+
+void hal_alarm_irq_set_enabled(uint alarm, bool enabled)
+{
+    count(MOCK_ALARM, 1, 0);
+    alarm_irq_enabled[alarm] = enabled;
+    if (enabled)
+        run_pended(); // während der Sperre angestoßen -> läuft jetzt
+}
+
+void hal_alarm_pend(uint alarm)
+{
+    count(MOCK_ALARM, 1, 0); // NVIC ISPR
+    alarm_pended[alarm] = true;
+    run_pended(); // aus dem Hauptprogramm sofort, aus einem Handler nach dessen Ende
+}
+
+// -------------------- ADC --------------------
+void hal_adc_stream_start(volatile uint16_t *buf, uint n)
+{
+    count(MOCK_ADC, 20, 0); // ADC, Pads, FIFO, 2 DMA-Kanäle (nur einmal beim Start)
+    adc_buf = buf;
+    adc_inputs = n;
+    for (uint i = 0; i < n; ++i)
+        buf[i] = 0;
+}
+
+uint hal_uart_dma_init(uint tx_pin, uint baud)
+{
+    (void)baud;
+    count(MOCK_UART_DMA, 12, 0); // UART (Baud, Format, Enable), Pad, DMA-Kanal
+    mock_pin[tx_pin].fn = GPIO_FUNC_UART;
+    return 0;
+}
+
+void hal_uart_dma_send(uint chan, const void *buf, uint len)
+{
+    (void)chan;
+    count(MOCK_UART_DMA, 2, 0); // Leseadresse + Anzahl mit Trigger
+    if (uart_tx_len + len > MOCK_UART_TX_MAX)
+        return;
+    memcpy(uart_tx + uart_tx_len, buf, len);
+    uart_tx_len += len;
+}
+
+bool hal_uart_dma_busy(uint chan)
+{
+    (void)chan;
+    count(MOCK_UART_DMA, 0, 1); // CTRL_TRIG.BUSY
+    return false;
+}
+
+// order wird ignoriert: Handler laufen in Registrierreihenfolge
+void hal_pwm_wrap_irq_init(uint slice, irq_handler_t isr, uint8_t priority, uint8_t order)
+{
+    (void)priority;
+    (void)order;
+    count(MOCK_PWM_MISC, 4, 0); // INTR, Handler, NVIC-Priorität, NVIC-Enable
+    for (int i = 0; i < MOCK_NUM_WRAP_HANDLERS; ++i)
+        if (!wrap_handler[i].isr)
+        {
+            wrap_handler[i].slice = slice;
+            wrap_handler[i].isr = isr;
+            break;
+        }
+}
+
+void hal_pwm_wrap_irq_set_enabled(uint slice, bool enabled)
+{
+    count(MOCK_PWM_MISC, 1, 0); // INTE
+    wrap_irq_enabled = enabled ? wrap_irq_enabled | (1u << slice) : wrap_irq_enabled & ~(1u << slice);
+}
+
+uint hal_pwm_wrap_dma_ring(uint slice, const volatile uint16_t *src, volatile uint16_t *ring, uint ring_bits)
+{
+    (void)slice;
+    count(MOCK_PWM_MISC, 10, 0); // zwei DMA-Kanäle konfigurieren (nur einmal beim Start)
+    wrap_src = src;
+    wrap_ring = ring;
+    wrap_ring_mask = (1u << ring_bits) - 1u;
+    wrap_pos = 0;
+    return 1;
+}
+
+uintptr_t hal_dma_write_addr(uint chan)
+{
+    (void)chan;
+    count(MOCK_PWM_MISC, 0, 1);
+    return (uintptr_t)wrap_ring + wrap_pos;
+}
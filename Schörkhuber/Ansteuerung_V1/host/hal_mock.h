@@ -0,0 +1,200 @@
+// hal_mock.h
+// Host-Ersatz für die RP2040-Hardware: gleiche hal_* Signaturen wie hal.h,
+// implementiert in hal_mock.c. Jeder Aufruf wird gezählt (Aufrufe je Funktion,
+// geschätzte Register-Schreib-/Lesezugriffe) und der Pin-/PWM-Zustand nachgebildet,
+// damit Benchmarks und Tests die Steuerlogik ohne Board ausführen können.
+
+#ifndef HAL_MOCK_H
+#define HAL_MOCK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// -------------------- Typen/Konstanten wie im Pico-SDK --------------------
+typedef unsigned int uint;
+typedef void (*irq_handler_t)(void);
+
+enum gpio_function
+{
+    GPIO_FUNC_UART = 2,
+    GPIO_FUNC_PWM = 4,
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_NULL = 0x1f
+};
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+enum gpio_override
+{
+    GPIO_OVERRIDE_NORMAL = 0,
+    GPIO_OVERRIDE_INVERT = 1,
+    GPIO_OVERRIDE_LOW = 2,
+    GPIO_OVERRIDE_HIGH = 3
+};
+
+#define MOCK_NUM_GPIO 30
+#define MOCK_NUM_PWM_SLICES 8
+#define MOCK_NUM_ALARMS 4
+#define MOCK_NUM_GPIO_HANDLERS 4
+#define MOCK_NUM_WRAP_HANDLERS 4
+#define MOCK_UART_TX_MAX 65536
+
+// -------------------- HAL (Signaturen identisch zu hal.h) --------------------
+void hal_gpio_init(uint pin);
+void hal_gpio_set_function(uint pin, enum gpio_function fn);
+void hal_gpio_set_dir(uint pin, bool out);
+void hal_gpio_put(uint pin, bool value);
+bool hal_gpio_get(uint pin);
+void hal_gpio_pull_up(uint pin);
+void hal_gpio_pull_down(uint pin);
+void hal_gpio_disable_pulls(uint pin);
+void hal_gpio_set_dir_masked(uint32_t mask, uint32_t value);
+void hal_gpio_set_oeover(uint pin, uint value);
+uint32_t hal_gpio_get_all(void);
+void hal_gpio_set_dir_in_masked(uint32_t mask);
+void hal_gpio_irq_init(uint32_t mask, irq_handler_t isr, uint8_t order);
+void hal_gpio_irq_set_edges(uint pin, bool rise, bool fall);
+void hal_gpio_irq_set_priority(uint8_t priority);
+uint32_t hal_gpio_irq_status(uint32_t mask);
+void hal_gpio_irq_ack(uint32_t mask);
+void hal_gpio_irq_force(uint pin, bool force);
+
+uint32_t hal_irq_save(void);
+void hal_irq_restore(uint32_t state);
+
+void hal_cycles_init(void);
+uint32_t hal_cycles(void);
+
+uint hal_pwm_gpio_to_slice_num(uint pin);
+uint hal_pwm_gpio_to_channel(uint pin);
+void hal_pwm_set_wrap(uint slice, uint16_t wrap);
+void hal_pwm_set_clkdiv_int_frac(uint slice, uint8_t div_int, uint8_t div_frac);
+void hal_pwm_set_phase_correct(uint slice, bool phase_correct);
+void hal_pwm_set_counter(uint slice, uint16_t c);
+void hal_pwm_wrap_clear(uint slice);
+bool hal_pwm_wrap_pending(uint slice);
+void hal_pwm_set_chan_level(uint slice, uint chan, uint16_t level);
+void hal_pwm_set_enabled(uint slice, bool enabled);
+void hal_pwm_set_mask_enabled(uint32_t mask);
+uint32_t hal_clock_sys_hz(void);
+
+// Host: Compiler- und CPU-Barriere (Erzeuger/Verbraucher können echte Threads sein)
+static inline void hal_mem_barrier(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+uint32_t hal_time_us_32(void);
+uint32_t hal_time_ms(void);
+void hal_busy_wait_us(uint32_t us);
+void hal_sleep_ms(uint32_t ms);
+
+void hal_alarm_init(uint alarm, irq_handler_t isr, uint8_t priority);
+void hal_alarm_arm(uint alarm, uint32_t target_us);
+void hal_alarm_disarm(uint alarm);
+void hal_alarm_ack(uint alarm);
+void hal_alarm_irq_set_enabled(uint alarm, bool enabled);
+void hal_alarm_pend(uint alarm);
+
+void hal_adc_stream_start(volatile uint16_t *buf, uint n);
+
+void hal_pwm_wrap_irq_init(uint slice, irq_handler_t isr, uint8_t priority, uint8_t order);
+void hal_pwm_wrap_irq_set_enabled(uint slice, bool enabled);
+uint hal_pwm_wrap_dma_ring(uint slice, const volatile uint16_t *src, volatile uint16_t *ring, uint ring_bits);
+uintptr_t hal_dma_write_addr(uint chan);
+
+uint hal_uart_dma_init(uint tx_pin, uint baud);
+void hal_uart_dma_send(uint chan, const void *buf, uint len);
+bool hal_uart_dma_busy(uint chan);
+
+// -------------------- Aufzeichnung --------------------
+// Ein Eintrag je HAL-Funktion, Reihenfolge wie oben
+typedef enum
+{
+    MOCK_GPIO_INIT,
+    MOCK_GPIO_SET_FUNCTION,
+    MOCK_GPIO_SET_DIR,
+    MOCK_GPIO_PUT,
+    MOCK_GPIO_GET,
+    MOCK_GPIO_PULL,
+    MOCK_GPIO_SET_DIR_MASKED,
+    MOCK_GPIO_SET_OEOVER,
+    MOCK_GPIO_IRQ,
+    MOCK_IRQ_SAVE_RESTORE,
+    MOCK_PWM_GPIO_TO_SLICE,
+    MOCK_PWM_GPIO_TO_CHANNEL,
+    MOCK_PWM_SET_WRAP,
+    MOCK_PWM_SET_CLKDIV,
+    MOCK_PWM_SET_CHAN_LEVEL,
+    MOCK_PWM_SET_ENABLED,
+    MOCK_PWM_SET_MASK_ENABLED,
+    MOCK_PWM_MISC,
+    MOCK_CLOCK_GET_HZ,
+    MOCK_TIME_READ,
+    MOCK_CYCLES,
+    MOCK_BUSY_WAIT,
+    MOCK_SLEEP,
+    MOCK_ALARM,
+    MOCK_ADC,
+    MOCK_UART_DMA,
+    MOCK_FN_COUNT
+} mock_fn_t;
+
+extern const char *const mock_fn_name[MOCK_FN_COUNT];
+
+typedef struct
+{
+    uint64_t calls[MOCK_FN_COUNT]; // Aufrufe je HAL-Funktion
+    uint64_t reg_writes;           // geschätzte Schreibzugriffe auf Peripherie-Register
+    uint64_t reg_reads;            // geschätzte Lesezugriffe auf Peripherie-Register
+    uint64_t busy_wait_us;         // Summe der Busy-Wait-Zeit (blockierte CPU)
+} mock_counters_t;
+
+// Nachgebildeter Zustand eines GPIO-Pins
+typedef struct
+{
+    enum gpio_function fn; // aktuelle Pin-Funktion
+    bool dir_out;          // SIO-Richtung (true = Ausgang)
+    bool out;              // SIO-Ausgangswert
+    uint oeover;           // Output-Enable-Override (GPIO_OVERRIDE_*)
+    bool ext_level;        // von außen angelegter Pegel (Taster, Fault-Signal)
+    bool ext_driven;       // Pegel per mock_set_input vorgegeben (Pull-Up/-Down ändert ihn nicht mehr)
+} mock_pin_t;
+
+// Nachgebildeter Zustand eines PWM-Slices
+typedef struct
+{
+    uint16_t wrap;
+    uint16_t level[2];  // Kanal A/B
+    uint8_t div_int;    // Taktteiler, ganzzahliger Teil
+    uint8_t div_frac;   // Taktteiler, Sechzehntel
+    bool phase_correct; // auf/ab zählen
+    uint16_t counter;
+    bool enabled;
+} mock_slice_t;
+
+extern mock_counters_t mock_count;
+extern mock_pin_t mock_pin[MOCK_NUM_GPIO];
+extern mock_slice_t mock_slice[MOCK_NUM_PWM_SLICES];
+
+// Gesamten Mock-Zustand (Pins, Zeit, Alarme, Zähler) zurücksetzen
+void mock_reset(void);
+// Nur die Zähler zurücksetzen (für Messungen)
+void mock_reset_counters(void);
+// Summe aller HAL-Aufrufe
+uint64_t mock_total_calls(void);
+// Externen Pegel an einem Eingang vorgeben (z. B. Taster gedrückt = false).
+// Ändert sich der Pegel eines Pins mit Flanken-Interrupt, laufen die zuständigen Handler sofort.
+void mock_set_input(uint pin, bool level);
+// Simulierte Zeit (µs seit Start); mock_advance_us löst fällige Alarme aus
+uint64_t mock_now_us(void);
+void mock_advance_us(uint32_t us);
+// ADC-Wert (12 bit) eines Eingangs vorgeben, landet wie per DMA im Puffer von hal_adc_stream_start
+void mock_set_adc(uint input, uint16_t value);
+// Ein PWM-Wrap: DMA-Kopie in den Ring (hal_pwm_wrap_dma_ring), danach die Wrap-Handler der
+// freigegebenen Slices
+void mock_pwm_wrap(void);
+// Per UART-DMA gesendete Bytes abholen (der Mock sendet sofort, DMA ist nie belegt).
+// Passt ein Puffer nicht mehr in MOCK_UART_TX_MAX, wird er verworfen.
+size_t mock_uart_take(uint8_t *out, size_t max);
+
+#endif // HAL_MOCK_H
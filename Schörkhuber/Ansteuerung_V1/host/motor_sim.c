@@ -0,0 +1,233 @@
+// motor_sim.c
+// Motormodell (siehe motor_sim.h). Explizites Euler-Verfahren; bei dt = 2 µs und L/R ~ 0,4 ms
+// ändert sich der Strom je Schritt um weniger als 1 %.
+
+#include "motor_sim.h"
+#include "bldc.h"
+#include "config.h"
+
+#include <math.h>
+
+#define TWO_PI 6.283185307179586
+
+// Spannungsteiler der Phasen 1:5 an 3,3 V / 12 bit -> 248 Counts/V (12 V = 2978 Counts)
+#define SIM_ADC_COUNTS_PER_V (4095.0 / 3.3 / 5.0)
+// Shunt wie im Beispiel in config.h: 10 mOhm, Verstärkung 20 -> 248 Counts/A
+#define SIM_SHUNT_COUNTS_PER_A 248.0
+
+static const uint8_t HALL_CODE_OF_STEP[6] = HALL_SEQUENCE;
+
+static uint16_t to_adc(double counts)
+{
+    if (counts < 0)
+        return 0;
+    return counts > 4095.0 ? 4095u : (uint16_t)counts;
+}
+
+// Rückmeldungen an die Steuerung: Phasenspannungen und Shunt an den ADC, Hall-Pegel
+static void feedback(motor_sim_t *s)
+{
+    for (uint ph = 0; ph < BEMF_ADC_INPUTS && ph < 3u; ++ph)
+        mock_set_adc(ph, to_adc(s->v_term[ph] * SIM_ADC_COUNTS_PER_V));
+    mock_set_adc(CURRENT_ADC_INPUT, to_adc(s->i_shunt * SIM_SHUNT_COUNTS_PER_A));
+
+    if (s->p.hall)
+    {
+        int sector = (int)floor((s->theta_el * (360.0 / TWO_PI) - 30.0) / 60.0);
+        int code = HALL_CODE_OF_STEP[(sector + 6) % 6];
+        if (code != s->hall_code)
+        {
+            // nacheinander wie echte Sensoren; zwischen zwei Sektoren ändert sich ohnehin nur ein Bit
+            mock_set_input(HALL_PIN_A, code & 1);
+            mock_set_input(HALL_PIN_B, (code >> 1) & 1);
+            mock_set_input(HALL_PIN_C, (code >> 2) & 1);
+            s->hall_code = code;
+        }
+    }
+}
+
+void motor_sim_default_params(motor_params_t *p)
+{
+    p->r_ohm = 0.5;
+    p->l_h = 0.2e-3;
+    p->ke_vs = 0.01;
+    p->j_kgm2 = 2e-5;
+    p->b_nms = 2e-6;
+    p->v_bus = 12.0;
+    p->v_diode = 0.7;
+    p->pole_pairs = MOTOR_POLE_PAIRS;
+    p->hall = false;
+}
+
+void motor_sim_init(motor_sim_t *s, const motor_params_t *p)
+{
+    *s = (motor_sim_t){0};
+    s->p = *p;
+    s->hall_code = -1;
+    feedback(s);
+}
+
+double motor_sim_rpm(const motor_sim_t *s)
+{
+    return s->omega * 60.0 / TWO_PI;
+}
+
+// Trapezform der Gegen-EMK von Phase A: +1 von 30° bis 150°, -1 von 210° bis 330°, dazwischen linear.
+// Passt zu COMMUTATION: Schritt k liefert das größte Moment für theta_el in [30° + k*60°, 90° + k*60°).
+static double trapezoid(double th)
+{
+    double d = fmod(th * (360.0 / TWO_PI), 360.0);
+    if (d < 0)
+        d += 360.0;
+    if (d < 30.0)
+        return d / 30.0;
+    if (d < 150.0)
+        return 1.0;
+    if (d < 210.0)
+        return (180.0 - d) / 30.0;
+    if (d < 330.0)
+        return -1.0;
+    return (d - 360.0) / 30.0;
+}
+
+// P-MOSFET leitet, wenn der HS-Pin SIO-Ausgang mit Wert 0 ist (Gate auf GND)
+static bool hs_on(int ph)
+{
+    const mock_pin_t *pin = &mock_pin[MAIN_MOTOR->hs_pin[ph]];
+    return pin->fn == GPIO_FUNC_SIO && pin->dir_out && !pin->out;
+}
+
+// Einschaltdauer der LS (0..1); 0, wenn der Treiber per Override aus ist
+static double ls_duty(int ph)
+{
+    const mock_pin_t *pin = &mock_pin[MAIN_MOTOR->ls_pin[ph]];
+    const mock_slice_t *sl = &mock_slice[MAIN_MOTOR->ls_slice[ph]];
+    if (pin->fn != GPIO_FUNC_PWM || pin->oeover == GPIO_OVERRIDE_LOW || !sl->enabled)
+        return 0.0;
+    double d = (double)sl->level[MAIN_MOTOR->ls_chan[ph]] / ((double)sl->wrap + 1.0);
+    return d > 1.0 ? 1.0 : d;
+}
+
+void motor_sim_step(motor_sim_t *s, double dt, double load_nm)
+{
+    const motor_params_t *p = &s->p;
+    double e[3];
+    double v[3];
+    bool cond[3];  // Phase führt Strom bzw. wird getrieben
+    bool diode[3]; // Strom fließt nur noch über eine Body-Diode
+    int n = 0;
+
+    double f[3];
+    for (int ph = 0; ph < 3; ++ph)
+    {
+        f[ph] = trapezoid(s->theta_el - ph * (TWO_PI / 3.0));
+        e[ph] = p->ke_vs * s->omega * f[ph];
+    }
+
+    // Klemmenspannung je Phase (über die PWM-Periode gemittelt)
+    s->i_shunt = 0;
+    for (int ph = 0; ph < 3; ++ph)
+    {
+        bool hs = hs_on(ph);
+        double d = ls_duty(ph);
+        diode[ph] = false;
+        cond[ph] = true;
+        if (hs && d > 0)
+            s->shoot++;
+        if (hs)
+            v[ph] = p->v_bus;
+        else if (d > 0)
+        {
+            // Strom aus dem Motor: in der Aus-Zeit Freilauf über die HS-Diode -> im Mittel Vbus*(1-d);
+            // Strom in den Motor: fließt über LS oder LS-Diode -> 0 V
+            v[ph] = s->i[ph] > 0 ? 0.0 : p->v_bus * (1.0 - d);
+            if (s->i[ph] < 0)
+                s->i_shunt -= s->i[ph];
+        }
+        else if (s->i[ph] > 0)
+        {
+            v[ph] = -p->v_diode; // LS-Diode
+            diode[ph] = true;
+        }
+        else if (s->i[ph] < 0)
+        {
+            v[ph] = p->v_bus + p->v_diode; // HS-Diode
+            diode[ph] = true;
+        }
+        else
+            cond[ph] = false;
+        n += cond[ph];
+    }
+
+    // Ströme: alle drei Phasen leitend -> Sternpunkt aus sum(i) = 0, zwei -> Reihenschaltung
+    double vn;
+    if (n == 3)
+    {
+        vn = (v[0] + v[1] + v[2] - e[0] - e[1] - e[2]) / 3.0;
+        for (int ph = 0; ph < 3; ++ph)
+            s->i[ph] += dt * (v[ph] - vn - p->r_ohm * s->i[ph] - e[ph]) / p->l_h;
+    }
+    else if (n == 2)
+    {
+        int a = cond[0] ? 0 : 1;
+        int b = cond[2] ? 2 : 1;
+        vn = (v[a] + v[b] - e[a] - e[b]) / 2.0;
+        double i = s->i[a];
+        i += dt * (v[a] - v[b] - 2.0 * p->r_ohm * i - (e[a] - e[b])) / (2.0 * p->l_h);
+        s->i[a] = i;
+        s->i[b] = -i;
+        s->i[3 - a - b] = 0;
+    }
+    else
+    {
+        vn = p->v_bus / 2.0;
+        for (int ph = 0; ph < 3; ++ph)
+            if (cond[ph])
+                vn = v[ph] - e[ph];
+        s->i[0] = s->i[1] = s->i[2] = 0;
+    }
+
+    // Diodenstrom erreicht null -> Phase sperrt, Rest auf die anderen beiden verteilen
+    for (int ph = 0; ph < 3; ++ph)
+        if (diode[ph] && (v[ph] < 0 ? s->i[ph] <= 0 : s->i[ph] >= 0))
+        {
+            s->i[ph] = 0;
+            int a = (ph + 1) % 3, b = (ph + 2) % 3;
+            double r = (s->i[a] - s->i[b]) / 2.0;
+            s->i[a] = r;
+            s->i[b] = -r;
+        }
+
+    // offene Phase: Sternpunkt + eigene Gegen-EMK (durch die Dioden auf die Schienen begrenzt)
+    s->p_in = 0;
+    for (int ph = 0; ph < 3; ++ph)
+    {
+        if (!cond[ph])
+        {
+            v[ph] = vn + e[ph];
+            if (v[ph] < -p->v_diode)
+                v[ph] = -p->v_diode;
+            if (v[ph] > p->v_bus + p->v_diode)
+                v[ph] = p->v_bus + p->v_diode;
+        }
+        s->v_term[ph] = v[ph];
+        s->p_in += v[ph] * s->i[ph];
+    }
+
+    // Mechanik
+    s->torque = p->ke_vs * (f[0] * s->i[0] + f[1] * s->i[1] + f[2] * s->i[2]);
+    double drive = s->torque - p->b_nms * s->omega;
+    if (s->omega == 0 && fabs(drive) <= load_nm)
+        drive = 0; // Haftreibung: Last hält den Rotor
+    else
+        drive -= s->omega >= 0 ? load_nm : -load_nm;
+    double omega = s->omega + dt * drive / p->j_kgm2;
+    if ((s->omega > 0 && omega < 0) || (s->omega < 0 && omega > 0))
+        omega = 0; // Last bremst bis zum Stillstand, nicht darüber hinaus
+    s->omega = omega;
+    s->theta_el = fmod(s->theta_el + dt * s->omega * p->pole_pairs, TWO_PI);
+    if (s->theta_el < 0)
+        s->theta_el += TWO_PI;
+
+    feedback(s);
+}
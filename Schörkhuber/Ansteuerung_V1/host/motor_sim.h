@@ -0,0 +1,58 @@
+// motor_sim.h
+// Motormodell für den Host-Build: dreiphasiger BLDC-Motor (Sternschaltung, trapezförmige
+// Gegen-EMK) an der Brücke aus bldc.c. Die Schaltzustände kommen direkt aus dem HAL-Mock
+// (HS: SIO-Richtung, LS: Output-Enable-Override + CC-Register des PWM-Slices), zurück gehen
+// Hall-Pegel (mock_set_input) und ADC-Werte der Phasenspannungen bzw. des Shunts (mock_set_adc).
+//
+// Elektrisch: je Phase R, L und e = ke * omega * f(theta_el); die PWM wird über eine Periode
+// gemittelt (LS-Phase liegt im Mittel auf Vbus * (1 - Duty)). Eine abgeschaltete Phase mit
+// Reststrom leitet über die Body-Diode (-Vd bzw. Vbus + Vd), bis der Strom null ist.
+// Mechanisch: J * domega/dt = M_el - B * omega - M_last (Haftreibung: Last hält den Rotor fest).
+
+#ifndef MOTOR_SIM_H
+#define MOTOR_SIM_H
+
+#include "hal.h"
+
+typedef struct
+{
+    double r_ohm;        // Widerstand je Phase
+    double l_h;          // Induktivität je Phase
+    double ke_vs;        // Gegen-EMK-Konstante je Phase (V pro rad/s mechanisch, Plateau)
+    double j_kgm2;       // Trägheitsmoment Rotor + Last
+    double b_nms;        // viskose Reibung
+    double v_bus;        // Zwischenkreisspannung
+    double v_diode;      // Flussspannung der Body-Dioden
+    unsigned pole_pairs; // Polpaare (wie MOTOR_POLE_PAIRS)
+    bool hall;           // Hall-Sensoren angeschlossen (sonst lesen die Pins 1 = Code 7)
+} motor_params_t;
+
+typedef struct
+{
+    motor_params_t p;
+    double i[3];      // Phasenströme (positiv = in den Motor hinein)
+    double omega;     // Winkelgeschwindigkeit mechanisch (rad/s)
+    double theta_el;  // elektrischer Winkel (rad, 0..2pi)
+    double torque;    // elektrisches Moment des letzten Schritts (Nm)
+    double p_in;      // an den Klemmen aufgenommene Leistung des letzten Schritts (W)
+    double v_term[3]; // Klemmenspannungen des letzten Schritts
+    double i_shunt;   // Strom durch eingeschaltete Low-Sides (Shunt), A
+    uint64_t shoot;   // Schritte mit HS und LS derselben Phase gleichzeitig ein (Brückenkurzschluss)
+    int hall_code;    // zuletzt ausgegebener Hall-Code (-1 = noch keiner)
+} motor_sim_t;
+
+// Typischer kleiner Außenläufer an 12 V (Leerlauf ~5700 U/min)
+void motor_sim_default_params(motor_params_t *p);
+
+// Rotor steht bei theta_el = 0; Hall-Pegel und ADC-Werte werden sofort gesetzt, also vor
+// control_init() aufrufen (hall_present() sieht dann die Sensoren)
+void motor_sim_init(motor_sim_t *s, const motor_params_t *p);
+
+// dt Sekunden integrieren: Schaltzustand von MAIN_MOTOR lesen, Ströme/Drehzahl fortschreiben, danach
+// Hall-Pins und ADC-Werte (Phasenspannungen, Shunt) im Mock setzen
+void motor_sim_step(motor_sim_t *s, double dt, double load_nm);
+
+// Drehzahl in U/min
+double motor_sim_rpm(const motor_sim_t *s);
+
+#endif // MOTOR_SIM_H
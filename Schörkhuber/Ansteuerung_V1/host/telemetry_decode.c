@@ -0,0 +1,125 @@
+// telemetry_decode.c
+// Telemetrie-Datenstrom (uart1, Format siehe telemetry.h) in CSV umwandeln.
+// Liest die Rohdaten aus einer Datei oder von stdin, sucht die Sync-Bytes, prüft die CRC
+// und schreibt je Messpunkt eine Zeile nach stdout. Zusammenfassung (Rahmen, CRC-Fehler,
+// fehlende Rahmen, auf dem Board verworfene Messpunkte) geht nach stderr.
+//
+// Aufnahme z. B.:  stty -F /dev/ttyUSB1 921600 raw && cat /dev/ttyUSB1 > telem.bin
+// Aufruf:          telemetry_decode [telem.bin] > telem.csv
+
+#include "telemetry.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define FRAME_MAX (TELEM_HEADER_LEN + 255u * TELEM_SAMPLE_LEN + TELEM_CRC_LEN)
+
+typedef struct
+{
+    unsigned long frames;      // gültige Rahmen
+    unsigned long samples;     // ausgegebene Messpunkte
+    unsigned long crc_errors;  // Rahmen mit falscher CRC
+    unsigned long lost_frames; // Lücken in der Rahmen-Nr.
+    unsigned long skipped;     // Bytes außerhalb eines Rahmens (Resync)
+    unsigned long dropped;     // auf dem Board verworfene Messpunkte (Ring voll)
+} decode_stats_t;
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static const char *mode_name(uint8_t flags)
+{
+    if (flags & TELEM_FLAG_HALL)
+        return "hall";
+    if (flags & TELEM_FLAG_SENSORLESS)
+        return "sensorless";
+    if (flags & TELEM_FLAG_SINE)
+        return "sine";
+    return "open-loop";
+}
+
+static void print_frame(const uint8_t *f, uint n, uint16_t seq)
+{
+    const uint8_t *p = f + TELEM_HEADER_LEN;
+    for (uint i = 0; i < n; ++i, p += TELEM_SAMPLE_LEN)
+    {
+        uint32_t t_us = get16(p) | ((uint32_t)get16(p + 2) << 16);
+        uint8_t flags = p[5];
+        printf("%u,%u,%u,%u,%u,%u,%u,%s,%u\n", seq, t_us, p[4], get16(p + 6), get16(p + 8), get16(p + 10),
+               (flags & TELEM_FLAG_FAULT) ? 1u : 0u, mode_name(flags), 1u << (flags >> TELEM_DECIM_SHIFT));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    if (argc > 1 && !(in = fopen(argv[1], "rb")))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    static uint8_t buf[2 * FRAME_MAX];
+    size_t len = 0;
+    size_t got;
+    decode_stats_t st = {0};
+    bool have_seq = false;
+    uint16_t next_seq = 0;
+    uint16_t last_dropped = 0;
+
+    printf("frame,t_us,step,pwm_level,current,voltage,fault,mode,decimation\n");
+    while ((got = fread(buf + len, 1, sizeof(buf) - len, in)) > 0 || len >= TELEM_HEADER_LEN)
+    {
+        len += got;
+        size_t pos = 0;
+        while (len - pos >= TELEM_HEADER_LEN)
+        {
+            const uint8_t *f = buf + pos;
+            if (f[0] != TELEM_SYNC0 || f[1] != TELEM_SYNC1)
+            {
+                pos++;
+                st.skipped++;
+                continue;
+            }
+            uint n = f[2];
+            size_t flen = TELEM_HEADER_LEN + n * TELEM_SAMPLE_LEN + TELEM_CRC_LEN;
+            if (len - pos < flen)
+                break; // Rahmen noch unvollständig
+            if (n == 0 || telemetry_crc16(f + 2, flen - 4) != get16(f + flen - 2))
+            {
+                st.crc_errors += (n != 0);
+                pos++; // Sync war zufällig in den Daten -> ein Byte weiter neu suchen
+                st.skipped++;
+                continue;
+            }
+
+            uint16_t seq = get16(f + 3);
+            uint16_t dropped = get16(f + 5);
+            if (have_seq)
+            {
+                st.lost_frames += (uint16_t)(seq - next_seq);
+                st.dropped += (uint16_t)(dropped - last_dropped);
+            }
+            have_seq = true;
+            next_seq = (uint16_t)(seq + 1);
+            last_dropped = dropped;
+
+            print_frame(f, n, seq);
+            st.frames++;
+            st.samples += n;
+            pos += flen;
+        }
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+        if (got == 0)
+            break; // Dateiende, Rest ist kein vollständiger Rahmen
+    }
+
+    fprintf(stderr, "frames=%lu samples=%lu crc_errors=%lu lost_frames=%lu skipped_bytes=%lu dropped_on_board=%lu\n",
+            st.frames, st.samples, st.crc_errors, st.lost_frames, st.skipped + len, st.dropped);
+    if (in != stdin)
+        fclose(in);
+    return 0;
+}
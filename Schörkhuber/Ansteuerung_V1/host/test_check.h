@@ -0,0 +1,44 @@
+// test_check.h
+// Prüfmakros für die Host-Tests (ctest, siehe CMakeLists.txt). Anders als assert() auch im
+// Release-Build (NDEBUG) aktiv; ein Fehler wird mit Datei/Zeile gemeldet, der Test läuft weiter,
+// main() gibt am Ende test_result() zurück.
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+static int test_failures;
+
+#define CHECK(cond)                                                           \
+    do                                                                        \
+    {                                                                         \
+        if (!(cond))                                                          \
+        {                                                                     \
+            fprintf(stderr, "%s:%d: CHECK(%s)\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                                  \
+        }                                                                     \
+    } while (0)
+
+// wie CHECK, mit den beiden Werten in der Meldung
+#define CHECK_EQ(a, b)                                                                                      \
+    do                                                                                                      \
+    {                                                                                                       \
+        long long a_ = (long long)(a), b_ = (long long)(b);                                                 \
+        if (a_ != b_)                                                                                       \
+        {                                                                                                   \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s): %lld != %lld\n", __FILE__, __LINE__, #a, #b, a_, b_); \
+            test_failures++;                                                                                \
+        }                                                                                                   \
+    } while (0)
+
+static inline int test_result(const char *name)
+{
+    if (test_failures)
+        fprintf(stderr, "%s: %d check(s) failed\n", name, test_failures);
+    else
+        printf("%s: ok\n", name);
+    return test_failures ? 1 : 0;
+}
+
+#endif // TEST_CHECK_H
@@ -0,0 +1,111 @@
+// test_comm_sched.c
+// Kommutations-Scheduler mit zwei Motoren an einem Alarm (Bibliothek mit MOTOR_COUNT = 2):
+// jeder Motor kommutiert im eigenen Takt ohne Drift, die Schritte kommen in der Reihenfolge ihrer
+// Termine, und gleichzeitig fällige Schritte verzögern sich höchstens um einen Schritt mit Totzeit.
+
+#include "bldc.h"
+#include "comm_sched.h"
+#include "config.h"
+#include "hal_mock.h"
+#include "test_check.h"
+
+_Static_assert(MOTOR_COUNT == 2u, "Test braucht die Bibliothek mit zwei Motoren");
+
+#define RUN_US 60000u
+#define LOG_MAX 256u
+// Spielraum: beobachtet wird erst nach dem Interrupt, also nach beiden Schritten, wenn beide
+// Motoren fällig sind (je 2 * Totzeit), plus Auflösung
+#define SLACK_US (4u * DEAD_TIME_US + 2u * COMM_MIN_LEAD_US)
+
+typedef struct
+{
+    uint8_t motor;
+    uint32_t planned; // Termin (deadline vor dem Schritt)
+    uint32_t at;      // beobachteter Zeitpunkt
+} step_log_t;
+
+static step_log_t steps[LOG_MAX];
+static uint n_steps;
+
+int main(void)
+{
+    static const uint32_t period[MOTOR_COUNT] = {1000u, 1500u};
+
+    mock_reset();
+    bldc_init();
+    comm_scheduler_init();
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+    {
+        motors[i].step_time_us = period[i];
+        motors[i].step_target_us = period[i]; // Rampe schon am Ziel: feste Schrittdauer
+        comm_scheduler_resume(&motors[i], PWM_WRAP / 2u);
+    }
+
+    uint8_t last_step[MOTOR_COUNT];
+    uint32_t planned[MOTOR_COUNT];
+    uint32_t first[MOTOR_COUNT];
+    uint count[MOTOR_COUNT] = {0};
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+    {
+        last_step[i] = motors[i].step;
+        planned[i] = motors[i].deadline;
+    }
+
+    // in 1-µs-Schritten laufen lassen und jeden Schrittwechsel mit seinem Termin aufzeichnen
+    while (mock_now_us() < RUN_US)
+    {
+        mock_advance_us(1);
+        for (uint i = 0; i < MOTOR_COUNT; ++i)
+        {
+            if (motors[i].step != last_step[i])
+            {
+                CHECK_EQ(motors[i].step, (last_step[i] + 1u) % 6u);
+                if (count[i] == 0)
+                    first[i] = planned[i];
+                if (n_steps < LOG_MAX)
+                    steps[n_steps++] = (step_log_t){(uint8_t)i, planned[i], (uint32_t)mock_now_us()};
+                last_step[i] = motors[i].step;
+                count[i]++;
+            }
+            planned[i] = motors[i].deadline;
+        }
+    }
+
+    for (uint i = 0; i < MOTOR_COUNT; ++i)
+    {
+        // keine Drift: Anzahl Schritte passt zur Laufzeit
+        uint expect = (RUN_US - 2u * COMM_MIN_LEAD_US) / period[i];
+        CHECK(count[i] + 1u >= expect && count[i] <= expect + 1u);
+        CHECK(motors[i].running);
+    }
+
+    uint both_due = 0;
+    for (uint k = 0; k < n_steps; ++k)
+    {
+        const step_log_t *s = &steps[k];
+        // Termine absolut im Raster des Motors, Schritt nie vor und höchstens SLACK_US nach dem Termin
+        CHECK_EQ((s->planned - first[s->motor]) % period[s->motor], 0);
+        CHECK((int32_t)(s->at - s->planned) >= 0);
+        CHECK((int32_t)(s->at - s->planned) <= (int32_t)SLACK_US);
+        if (k == 0)
+            continue;
+        // Reihenfolge der Termine (gleich fällige: Motor 0 zuerst, derselbe Interrupt)
+        const step_log_t *p = &steps[k - 1];
+        CHECK((int32_t)(s->planned - p->planned) >= -(int32_t)COMM_MIN_LEAD_US);
+        if (s->planned == p->planned)
+        {
+            CHECK(p->motor < s->motor);
+            both_due++;
+        }
+    }
+    CHECK(both_due > 0); // alle 3 ms sind beide Motoren gleichzeitig fällig
+
+    // Stopp eines Motors lässt den anderen weiterlaufen
+    comm_scheduler_stop(&motors[0]);
+    uint8_t s0 = motors[0].step, s1 = motors[1].step;
+    mock_advance_us(10000u);
+    CHECK_EQ(motors[0].step, s0);
+    CHECK(motors[1].step != s1);
+
+    return test_result("test_comm_sched");
+}
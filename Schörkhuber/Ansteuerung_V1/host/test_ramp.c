@@ -0,0 +1,60 @@
+// test_ramp.c
+// Rampe (ramp.c): beim Beschleunigen wird die Schrittdauer nie länger, beim Verzögern nie kürzer,
+// sie schießt nicht über das Ziel hinaus und erreicht es in endlich vielen Schritten genau.
+
+#include "config.h"
+#include "ramp.h"
+#include "test_check.h"
+
+#define MAX_STEPS 100000u
+
+// Rampe von from_us nach to_us fahren; Rückgabe: Anzahl Schritte bis zum Ziel (0 = nie erreicht)
+static uint32_t run(uint32_t from_us, uint32_t to_us)
+{
+    ramp_t r;
+    ramp_reset(&r, from_us);
+    uint32_t prev = from_us;
+    bool faster = to_us < from_us;
+    for (uint32_t n = 1; n <= MAX_STEPS; ++n)
+    {
+        uint32_t dt = ramp_next(&r, to_us);
+        if (faster)
+        {
+            CHECK(dt <= prev);  // monoton schneller
+            CHECK(dt >= to_us); // kein Überschwingen
+        }
+        else
+        {
+            CHECK(dt >= prev);
+            CHECK(dt <= to_us);
+        }
+        prev = dt;
+        if (!ramp_running(&r, to_us))
+        {
+            CHECK_EQ(ramp_next(&r, to_us), to_us); // am Ziel genau die vorgegebene Schrittdauer
+            return n;
+        }
+    }
+    return 0;
+}
+
+int main(void)
+{
+    // Anlauf aus dem Stand bis zur kürzesten Schrittdauer und zurück
+    uint32_t up = run(RAMP_START_US, STEP_TIME_MIN_US);
+    CHECK(up > 0);
+    uint32_t down = run(STEP_TIME_MIN_US, RAMP_START_US);
+    CHECK(down > 0);
+
+    // Schritte bis zur Drehzahl ~ v^2 / 2a (mit Ruck etwas mehr), in beide Richtungen ähnlich viele
+    uint32_t v_max = 1000000u / STEP_TIME_MIN_US;
+    uint32_t expect = v_max * v_max / (2u * RAMP_ACCEL);
+    CHECK(up + expect / 50u >= expect && up <= 2u * expect);
+    CHECK(down + 2u >= up / 2u && down <= 2u * up);
+
+    // kleine Änderung, Ziel schon erreicht
+    CHECK(run(1000u, 990u) > 0);
+    CHECK_EQ(run(1000u, 1000u), 1);
+
+    return test_result("test_ramp");
+}
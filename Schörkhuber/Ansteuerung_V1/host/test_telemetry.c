@@ -0,0 +1,126 @@
+// test_telemetry.c
+// Telemetrie hin und zurück: Rahmen mit telemetry_pack() packen (Firmware-Seite), mit Störbytes,
+// einem verfälschten und einem fehlenden Rahmen in eine Datei schreiben und durch den echten
+// Decoder (telemetry_decode, Pfad als Argument) schicken. Jeder Messpunkt muss unverändert
+// herauskommen, die Zusammenfassung die Fehler zählen.
+//
+// Aufruf (ctest): test_telemetry <pfad/zu/telemetry_decode>
+
+#include "telemetry.h"
+#include "test_check.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SAMPLES 5u
+
+static const telem_sample_t *expected[2 * SAMPLES];
+
+static void fill(telem_sample_t *s, uint n, uint32_t t0)
+{
+    for (uint i = 0; i < n; ++i)
+        s[i] = (telem_sample_t){t0 + i * 1001u, (uint8_t)(i % 6u), (uint8_t)(TELEM_FLAG_SENSORLESS | (i & 1u)),
+                                (uint16_t)(30000u + i), (uint16_t)(100u + i), (uint16_t)(2000u - i)};
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: test_telemetry <telemetry_decode>\n");
+        return 2;
+    }
+
+    // CRC-16/CCITT-FALSE, Prüfwert aus der Spezifikation
+    CHECK_EQ(telemetry_crc16((const uint8_t *)"123456789", 9), 0x29b1);
+
+    static uint8_t f0[TELEM_HEADER_LEN + SAMPLES * TELEM_SAMPLE_LEN + TELEM_CRC_LEN];
+    static uint8_t f1[sizeof(f0)], f2[sizeof(f0)], bad[sizeof(f0)];
+    telem_sample_t s0[SAMPLES], s1[SAMPLES], s2[SAMPLES];
+    fill(s0, SAMPLES, 0xfffff000u); // Zeitstempel über den 16-bit- und den 32-bit-Überlauf
+    fill(s1, SAMPLES, 12345u);
+    fill(s2, SAMPLES, 99999u);
+    size_t len = telemetry_pack(f0, s0, SAMPLES, 7, 0);
+    CHECK_EQ(len, sizeof(f0));
+    telemetry_pack(f1, s1, SAMPLES, 8, 0);  // geht verloren
+    telemetry_pack(f2, s2, SAMPLES, 9, 3); // 3 Messpunkte auf dem Board verworfen
+    memcpy(bad, f1, len);
+    bad[TELEM_HEADER_LEN + 4] ^= 0x10u; // ein Bit im Schritt des ersten Messpunkts
+
+    char path[] = "/tmp/test_telemetry_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    FILE *out = fdopen(fd, "wb");
+    static const uint8_t junk[] = {0x00, TELEM_SYNC0, 0x13, TELEM_SYNC0};
+    fwrite(junk, 1, sizeof(junk), out);
+    fwrite(f0, 1, len, out);
+    fwrite(bad, 1, len, out);
+    fwrite(f2, 1, len, out);
+    fclose(out);
+
+    for (uint i = 0; i < SAMPLES; ++i)
+    {
+        expected[i] = &s0[i];
+        expected[SAMPLES + i] = &s2[i];
+    }
+
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "'%s' '%s' 2>&1", argv[1], path);
+    FILE *in = popen(cmd, "r");
+    CHECK(in != NULL);
+    char line[256];
+    uint rows = 0;
+    bool header = false, summary = false;
+    while (in && fgets(line, sizeof(line), in))
+    {
+        if (strncmp(line, "frame,", 6) == 0)
+        {
+            header = true;
+            continue;
+        }
+        if (strncmp(line, "frames=", 7) == 0)
+        {
+            summary = true;
+            unsigned long frames, samples, crc, lost, skipped, dropped;
+            CHECK_EQ(sscanf(line, "frames=%lu samples=%lu crc_errors=%lu lost_frames=%lu skipped_bytes=%lu dropped_on_board=%lu",
+                            &frames, &samples, &crc, &lost, &skipped, &dropped),
+                     6);
+            CHECK_EQ(frames, 2);
+            CHECK_EQ(samples, 2 * SAMPLES);
+            CHECK_EQ(lost, 1);
+            CHECK_EQ(dropped, 3);
+            CHECK(crc >= 1);
+            CHECK(skipped >= sizeof(junk) + len - 1);
+            continue;
+        }
+        unsigned seq, t_us, step, level, current, voltage, fault, decim;
+        char mode[16];
+        int n = sscanf(line, "%u,%u,%u,%u,%u,%u,%u,%15[^,],%u", &seq, &t_us, &step, &level, &current, &voltage,
+                       &fault, mode, &decim);
+        CHECK_EQ(n, 9);
+        if (n != 9 || rows >= 2 * SAMPLES)
+        {
+            rows++;
+            continue;
+        }
+        const telem_sample_t *e = expected[rows];
+        CHECK_EQ(seq, rows < SAMPLES ? 7 : 9);
+        CHECK_EQ(t_us, e->t_us);
+        CHECK_EQ(step, e->step);
+        CHECK_EQ(level, e->pwm_level);
+        CHECK_EQ(current, e->current);
+        CHECK_EQ(voltage, e->voltage);
+        CHECK_EQ(fault, e->flags & TELEM_FLAG_FAULT);
+        CHECK(strcmp(mode, "sensorless") == 0);
+        CHECK_EQ(decim, 1);
+        rows++;
+    }
+    CHECK(in && pclose(in) == 0);
+    unlink(path);
+
+    CHECK(header);
+    CHECK(summary);
+    CHECK_EQ(rows, 2 * SAMPLES);
+    return test_result("test_telemetry");
+}
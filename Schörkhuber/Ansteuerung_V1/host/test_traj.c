@@ -0,0 +1,99 @@
+// test_traj.c
+// Trajektorie (traj.c): Punkte zum Termin, Stopp verwirft nur Punkte von vor dem Stopp, Stopp und
+// Start in einem Takt werden in Aufrufreihenfolge übernommen.
+
+#include "config.h"
+#include "traj.h"
+#include "test_check.h"
+
+#define LOG_MAX 16u
+
+static traj_point_t applied[LOG_MAX];
+static uint n_applied;
+
+static void apply(const traj_point_t *p)
+{
+    if (n_applied < LOG_MAX)
+        applied[n_applied] = *p;
+    n_applied++;
+}
+
+static void push(uint32_t t_ms, uint32_t value)
+{
+    traj_point_t p = {t_ms, value, TRAJ_SPEED};
+    CHECK_EQ(traj_push(&p, 1), 1);
+}
+
+// Stopp so, wie ihn core0 schickt (CTRL_CMD_TRAJ_STOP mit traj_pushed())
+static void stop(void)
+{
+    traj_stop(traj_pushed());
+}
+
+int main(void)
+{
+    uint32_t now = 1000000u;
+    traj_init(apply);
+
+    // Termine: 0 ms sofort, 5 ms erst nach 5 Takten
+    push(0, 100);
+    push(5, 200);
+    traj_start();
+    traj_tick(now);
+    CHECK_EQ(n_applied, 1);
+    CHECK_EQ(applied[0].value, 100);
+    for (int i = 1; i < 5; ++i)
+        traj_tick(now + i * SPEED_CTRL_PERIOD_US);
+    CHECK_EQ(n_applied, 1);
+    traj_tick(now + 5u * SPEED_CTRL_PERIOD_US);
+    CHECK_EQ(n_applied, 2);
+    CHECK_EQ(applied[1].value, 200);
+
+    // Stopp, neues Profil hochladen, Start - alles vor dem nächsten Takt: der Rest des alten
+    // Profils (301, schon als nächster Punkt gehalten) fällt weg, das neue läuft
+    now += 10000u;
+    n_applied = 0;
+    push(0, 300);
+    push(50, 301);
+    traj_start();
+    traj_tick(now);
+    CHECK_EQ(n_applied, 1); // 300 ausgeführt, 301 wartet in next
+    stop();
+    push(0, 400);
+    push(1, 401);
+    traj_start();
+    traj_tick(now + SPEED_CTRL_PERIOD_US);
+    CHECK_EQ(n_applied, 2);
+    CHECK_EQ(applied[1].value, 400);
+    traj_tick(now + 2u * SPEED_CTRL_PERIOD_US);
+    CHECK_EQ(n_applied, 3);
+    CHECK_EQ(applied[2].value, 401);
+
+    traj_stats_t st;
+    traj_get_stats(&st);
+    CHECK(st.running);
+    CHECK_EQ(st.queued, 0);
+
+    // Start und danach Stopp im selben Takt: bleibt gestoppt, Punkte von vorher verworfen
+    now += 10000u;
+    n_applied = 0;
+    push(0, 500);
+    traj_start();
+    stop();
+    traj_tick(now);
+    CHECK_EQ(n_applied, 0);
+    traj_get_stats(&st);
+    CHECK(!st.running);
+    CHECK_EQ(st.queued, 0);
+
+    // nach dem Stopp hochgeladen, aber erst mit dem nächsten Start ausgeführt
+    push(0, 600);
+    traj_tick(now + SPEED_CTRL_PERIOD_US);
+    CHECK_EQ(n_applied, 0);
+    traj_start();
+    traj_tick(now + 2u * SPEED_CTRL_PERIOD_US);
+    CHECK_EQ(n_applied, 1);
+    CHECK_EQ(applied[0].value, 600);
+
+    return test_result("test_traj");
+}
@@ -0,0 +1,85 @@
+// motor.h
+// Motor-Instanz: Pins, Zustand der Leistungsstufe, Kommutations-Timing und Fault-Eingang eines
+// Motors in einer Struktur. Ein RP2040 treibt damit mehrere Motoren (MOTOR_COUNT, Pins in
+// MOTOR_PINS, siehe config.h); bldc.c schaltet die Brücke eines Motors, comm_sched.c
+// kommutiert alle Motoren mit einem gemeinsamen Hardware-Alarm, jeden mit eigener Schrittdauer.
+//
+// Motor 0 (MAIN_MOTOR) ist der Hauptantrieb: nur er hat Hall-Sensoren, Gegen-EMK (der ADC hat
+// drei Phaseneingänge), Sinus-Betrieb, Strommessung, Drehzahlregler und Telemetrie. Weitere
+// Motoren laufen im Open-Loop. Ein Fehler am FAULT-Pin eines Motors schaltet nur diesen ab,
+// der gemeinsame E-Stop alle.
+
+#ifndef MOTOR_H
+#define MOTOR_H
+
+#include "config.h"
+#include "hal.h"
+#include "ramp.h"
+
+// Betriebsart der Kommutation
+typedef enum
+{
+    COMM_OPEN_LOOP,  // Schrittdauer vorgegeben (Rampe auf step_target_us)
+    COMM_SENSORLESS, // Schrittdauer aus Gegen-EMK-Nulldurchgängen (nur MAIN_MOTOR)
+    COMM_HALL,       // Schritt aus der Hall-Flanke (hall.c), kein eigener Termin (nur MAIN_MOTOR)
+} comm_mode_t;
+
+typedef struct
+{
+    // -------- Konfiguration (bldc_init aus MOTOR_PINS) --------
+    uint8_t hs_pin[3];    // HS-Gate je Phase A,B,C (SIO-Richtung)
+    uint8_t ls_pin[3];    // LS-Gate je Phase A,B,C (PWM)
+    uint8_t ls_slice[3];  // PWM-Slice der LS-Pins
+    uint8_t ls_chan[3];   // PWM-Kanal (A/B) der LS-Pins
+    uint8_t fault_pin;    // eigener FAULT-Eingang (active HIGH), MOTOR_NO_PIN = keiner
+    uint32_t hs_mask[3];  // SIO-Richtungsbit des HS je Phase
+    uint32_t hs_all_mask; // alle drei HS
+
+    // -------- Leistungsstufe (bldc.c) --------
+    uint16_t ls_level[3];          // zuletzt ins CC-Register geschriebener Duty je Phase
+    uint16_t ls_req[3];            // angeforderter Duty je Phase (vor der Strombegrenzung)
+    volatile uint16_t level_limit; // Duty-Grenze der Strombegrenzung (current.c)
+    volatile bool fault_latched;   // Fehler gespeichert (siehe bldc_emergency_off)
+    int8_t current_ls;             // commutate_step: aktuell eingeschalteter LS (-1 = keiner)
+    int8_t current_step;           // commutate_step (PIO): aktuell geschalteter Schritt
+    uint8_t sine_hs;               // Sinus-Betrieb: Phase mit eingeschaltetem HS (3 = keine)
+    uint8_t sine_next;             // Ziel eines laufenden Wechsels
+    uint8_t sine_stage;            // 0 = kein Wechsel, 1 = LS der neuen Phase aus, 2 = HS umgeschaltet
+
+    // -------- Kommutation (comm_sched.c) --------
+    // Dauer der laufenden Kommutationsstufe in µs. Im Open-Loop führt der Interrupt sie Schritt
+    // für Schritt über die Rampe (ramp.h) an step_target_us heran, im Sensorless-Betrieb steht hier
+    // die gemessene Schrittdauer (Anzeige, Startwert nach einem Rückfall).
+    volatile uint32_t step_time_us;
+    volatile uint32_t step_target_us; // Ziel-Schrittdauer im Open-Loop; darf jederzeit geändert werden
+    ramp_t ramp;                      // Beschleunigungsrampe (Kommutations-Interrupt, im Sinus-Betrieb control.c)
+    bool aligning;                    // nächster Schritt = Ausrichten (RAMP_ALIGN_MS mit RAMP_ALIGN_LEVEL)
+    volatile uint16_t pwm_level;      // Duty, mit dem der Interrupt kommutiert
+    volatile bool running;            // Scheduler kommutiert diesen Motor
+    volatile comm_mode_t mode;        // Betriebsart
+    volatile uint32_t deadline;       // geplanter Zeitpunkt des nächsten Schritts (timerawl)
+    uint32_t next_at;                 // nächster Alarm dieses Motors (Schritt oder ZC-Abfrage)
+    uint8_t step;                     // nächster Kommutationsschritt (0..5)
+    bool polling;                     // nächster Termin = ZC-Abfrage statt Kommutation
+    uint32_t last_step;               // Zeitpunkt der letzten Kommutation
+    uint32_t last_zc;                 // Zeitpunkt des letzten Nulldurchgangs
+    uint32_t period;                  // gefilterte Schrittdauer (60° el.) im Sensorless
+    uint32_t lost;                    // Schritte in Folge ohne Nulldurchgang
+    volatile int8_t hall_step;        // Hall: von der Flanke gemeldeter, noch nicht geschalteter Schritt (-1 = keiner)
+    volatile uint32_t hall_edge_us;   // Hall: Zeitstempel dieser Flanke
+    bool resync;                      // Open-Loop nach Sync-Verlust ab gemessener Schrittdauer, noch kein Nulldurchgang
+    int32_t last_jitter;              // Abweichung des letzten Schritts (Schrittabstand für STATS)
+    bool jitter_valid;                // last_jitter gehört zum laufenden Betrieb (nicht vor dem Start)
+} motor_t;
+
+extern motor_t motors[MOTOR_COUNT];
+
+#define MAIN_MOTOR (&motors[0])
+
+// Index eines Motors (für Meldungen)
+static inline uint motor_index(const motor_t *m)
+{
+    return (uint)(m - motors);
+}
+
+#endif // MOTOR_H
@@ -0,0 +1,147 @@
+// perf.c
+// Histogramme der Laufzeitmessung, siehe perf.h. Klassen linear mit Breite 2^shift ab lo,
+// damit das Einsortieren ohne Division auskommt (der M0+ hat auch kein CLZ für log2-Klassen).
+
+#include "perf.h"
+#include "dlog.h"
+
+#include <stdio.h>
+
+typedef struct
+{
+    const char *name;
+    int32_t lo;    // untere Grenze der ersten Klasse
+    uint8_t shift; // Klassenbreite 2^shift
+    bool cycles;   // Werte in SysTick-Takten (Ausgabe in µs)
+} perf_cfg_t;
+
+// Klassen so gewählt, dass der Normalfall in der Mitte liegt: Totzeit/Kommutation mit Busy-Wait
+// ~2 * DEAD_TIME_US (bei 125 MHz 1 µs = 125 Takte), Reaktionszeit < 1 µs, Schrittabstand +-32 µs
+static const perf_cfg_t PERF_CFG[PERF_COUNT] = {
+    [PERF_COMMUTATE] = {"commutate_step", 0, 7, true},   // 0..32 µs in ~1-µs-Klassen
+    [PERF_DEADTIME] = {"deadtime", 0, 7, true},          // 0..32 µs
+    [PERF_INTERVAL] = {"interval error", -32, 1, false}, // -32..+31 µs in 2-µs-Klassen
+    [PERF_FAULT] = {"fault reaction", 0, 3, true},       // 0..2 µs in 64-ns-Klassen
+};
+
+static perf_hist_t perf_hist[PERF_COUNT]; // schreiben nur Interrupts auf core1 (und perf_poll)
+static perf_hist_t snapshot[PERF_COUNT];  // schreibt perf_poll, solange snap_req != snap_ack
+
+// Anforderungen: core0 erhöht req, core1 setzt ack = req, wenn erledigt
+static volatile uint32_t snap_req;
+static volatile uint32_t snap_ack;
+static volatile uint32_t reset_req;
+static volatile uint32_t reset_ack;
+static uint32_t printed; // zuletzt ausgegebene Momentaufnahme (nur core0)
+
+void perf_add(perf_id_t id, int32_t value)
+{
+    const perf_cfg_t *c = &PERF_CFG[id];
+    int32_t i = (value - c->lo) >> c->shift;
+    if (i < 0)
+        i = 0;
+    else if (i >= (int32_t)PERF_BUCKETS)
+        i = PERF_BUCKETS - 1;
+
+    // ein Histogramm füllen mehrere Interrupt-Prioritäten (Fault unterbricht die Kommutation)
+    perf_hist_t *h = &perf_hist[id];
+    uint32_t irq = hal_irq_save();
+    h->bucket[i]++;
+    if (h->count == 0 || value < h->min)
+        h->min = value;
+    if (h->count == 0 || value > h->max)
+        h->max = value;
+    h->count++;
+    hal_irq_restore(irq);
+}
+
+void perf_poll(void)
+{
+    uint32_t req = snap_req;
+    if (req != snap_ack)
+    {
+        uint32_t irq = hal_irq_save(); // alle Schreiber laufen auf core1 -> Kopie ist konsistent
+        for (uint i = 0; i < PERF_COUNT; ++i)
+            snapshot[i] = perf_hist[i];
+        hal_irq_restore(irq);
+        hal_mem_barrier(); // Momentaufnahme vor ack sichtbar
+        snap_ack = req;
+    }
+    req = reset_req;
+    if (req != reset_ack)
+    {
+        uint32_t irq = hal_irq_save();
+        for (uint i = 0; i < PERF_COUNT; ++i)
+            perf_hist[i] = (perf_hist_t){0};
+        hal_irq_restore(irq);
+        reset_ack = req;
+        DLOG("STATS reset\n");
+    }
+}
+
+void perf_request_snapshot(void)
+{
+    snap_req = snap_req + 1u;
+}
+
+void perf_request_reset(void)
+{
+    reset_req = reset_req + 1u;
+}
+
+// Wert in 1/1000 µs (ns) für die Ausgabe; Takte über die Systemfrequenz umrechnen
+static int32_t to_ns(const perf_cfg_t *c, int32_t v)
+{
+    if (!c->cycles)
+        return v * 1000;
+    return (int32_t)((int64_t)v * 1000000000 / hal_clock_sys_hz());
+}
+
+static void print_us(int32_t ns)
+{
+    printf("%s%d.%03d", ns < 0 ? "-" : "", (ns < 0 ? -ns : ns) / 1000, (ns < 0 ? -ns : ns) % 1000);
+}
+
+bool perf_print(void)
+{
+    // erst ausgeben, wenn die jüngste Anforderung erledigt ist: dann schreibt core1 nicht mehr hinein
+    uint32_t ack = snap_ack;
+    if (ack != snap_req || ack == printed)
+        return false;
+    printed = ack;
+    hal_mem_barrier(); // ack vor der Momentaufnahme lesen
+
+    for (uint id = 0; id < PERF_COUNT; ++id)
+    {
+        const perf_cfg_t *c = &PERF_CFG[id];
+        const perf_hist_t h = snapshot[id];
+        printf("STATS %s: n=%u", c->name, h.count);
+        if (h.count == 0)
+        {
+            printf("\n");
+            continue;
+        }
+        printf(" min=");
+        print_us(to_ns(c, h.min));
+        printf(" max=");
+        print_us(to_ns(c, h.max));
+        printf(" us\n");
+        for (uint i = 0; i < PERF_BUCKETS; ++i)
+        {
+            if (!h.bucket[i])
+                continue;
+            int32_t lo = c->lo + (int32_t)(i << c->shift);
+            printf("  %s", i == 0 ? "<" : "");
+            print_us(to_ns(c, i == 0 ? lo + (1 << c->shift) : lo));
+            if (i == PERF_BUCKETS - 1)
+                printf("+");
+            else if (i > 0)
+            {
+                printf("..");
+                print_us(to_ns(c, lo + (1 << c->shift)));
+            }
+            printf(" us: %u\n", h.bucket[i]);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+// perf.h
+// Ständig mitlaufende Laufzeitmessung des Echtzeitteils (core1) in Histogrammen mit festen
+// Klassen, statisch angelegt: Dauer von commutate_step() und der Software-Totzeit (SysTick-Takte),
+// Abweichung des tatsächlichen vom geplanten Schrittabstand (µs) und die Reaktionszeit der
+// Not-Abschaltung (Takte). Kosten je Messwert: zwei SysTick-Lesungen bzw. eine Subtraktion,
+// ein Shift und drei Zähler unter kurz gesperrten Interrupts.
+//
+// Abfrage über die serielle Konsole: "STATS" gibt alle Histogramme aus, "STATS RESET" löscht sie.
+// core0 liest die Zähler nie direkt: beides sind Anforderungen (Zähler req/ack, wie der
+// Sequenz-Zähler in hall.c), die core1 in perf_poll() erledigt. core1 kopiert die Histogramme
+// unter gesperrten Interrupts in eine Momentaufnahme und meldet sie erst danach als fertig;
+// core0 gibt sie beim nächsten perf_print() aus.
+
+#ifndef PERF_H
+#define PERF_H
+
+#include "hal.h"
+
+#define PERF_BUCKETS 32u
+
+typedef enum
+{
+    PERF_COMMUTATE, // commutate_step(): Eintritt bis Ausgänge geschaltet (Takte)
+    PERF_DEADTIME,  // deadtime_delay_us(): tatsächliche Wartezeit (Takte)
+    PERF_INTERVAL,  // Schrittabstand tatsächlich - geplant (µs, vorzeichenbehaftet)
+    PERF_FAULT,     // Fault-Interrupt: Eintritt bis Ausgänge aus (Takte)
+    PERF_COUNT
+} perf_id_t;
+
+typedef struct
+{
+    uint32_t bucket[PERF_BUCKETS]; // Klasse i: lo + i * 2^shift .. (erste/letzte: alles darunter/darüber)
+    uint32_t count;                // Messwerte gesamt
+    int32_t min;
+    int32_t max;
+} perf_hist_t;
+
+// Takte seit start = hal_cycles() (SysTick ist 24 bit breit)
+static inline uint32_t perf_cycles_since(uint32_t start)
+{
+    return (hal_cycles() - start) & 0x00ffffffu;
+}
+
+// ---- core1 ----
+// Messwert einsortieren (aus jedem Interrupt erlaubt)
+void perf_add(perf_id_t id, int32_t value);
+// Anforderungen von core0 erledigen: Momentaufnahme veröffentlichen, dann ggf. löschen
+// (aus control_poll(), auch während eines Faults)
+void perf_poll(void);
+
+// ---- core0 ----
+// Momentaufnahme anfordern (STATS) bzw. Löschen anfordern (STATS RESET, Meldung per DLOG)
+void perf_request_snapshot(void);
+void perf_request_reset(void);
+// Angeforderte Momentaufnahme mit printf ausgeben, sobald core1 sie veröffentlicht hat (nur
+// belegte Klassen, Takte in µs umgerechnet). false = nichts Neues.
+bool perf_print(void);
+
+#endif // PERF_H
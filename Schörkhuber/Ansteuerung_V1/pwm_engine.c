@@ -0,0 +1,168 @@
+// pwm_engine.c
+// Ganzzahlige Timing-Berechnung und synchroner Betrieb der PWM-Slices (siehe pwm_engine.h).
+//
+// Periode in Systemtakten: (top + 1) * div16 / 16 * k, k = 2 im mittenzentrierten Betrieb.
+// Gesucht sind top und div16 (Teiler in Sechzehnteln, 16..4095) mit
+// (top + 1) * div16 * freq_hz * k == 16 * sys_hz; der Rest ist der Frequenzfehler.
+//
+// Frequenzwechsel im Betrieb: passt der bisherige Teiler, ändert sich nur TOP. TOP und CC sind
+// in der Hardware doppelt gepuffert und werden von allen Slices gemeinsam am Wrap übernommen
+// -> kein Glitch. Nur wenn ein anderer Teiler nötig ist (z. B. unter ~950 Hz mittenzentriert),
+// muss DIV (ungepuffert) direkt nach dem Wrap geschrieben werden, an dem TOP wechselt. Das macht
+// ein eigener Wrap-Handler, der nur für diesen einen Wrap freigegeben wird; vorher wurde dafür
+// bis zu einer alten Periode mit gesperrten Interrupts gewartet (bei 1 kHz 1 ms ohne Kommutation).
+
+#include "pwm_engine.h"
+#include "config.h"
+
+#define PWM_SLICES 8u    // RP2040
+#define DIV16_MIN 16u    // Teiler 1.0
+#define DIV16_MAX 4095u  // Teiler 255 + 15/16
+#define STEPS_MAX 65535u // TOP <= 65534, damit CC = TOP + 1 (100 % Duty) noch darstellbar ist
+
+static pwm_timing_t timing;
+static uint32_t slices;               // benutzte Slices (Bitmaske)
+static uint16_t level[PWM_SLICES][2]; // Duty je Kanal (0..PWM_WRAP), für die Umrechnung bei Frequenzwechsel
+static uint wrap_slice;               // sein Wrap-Interrupt setzt einen neuen Teiler
+static volatile bool div_pending;     // Teiler aus timing noch nicht geschrieben
+
+// Duty 0..PWM_WRAP -> CC-Wert 0..top+1 (gerundet; PWM_WRAP ergibt top+1 = 100 %)
+static inline uint16_t to_counts(uint16_t lvl)
+{
+    if (lvl >= PWM_WRAP)
+        return (uint16_t)(timing.top + 1u);
+    return (uint16_t)(((uint32_t)lvl * (timing.top + 1u) + (PWM_WRAP + 1u) / 2u) / (PWM_WRAP + 1u));
+}
+
+// Timing mit festem Teiler; err = Abweichung der Periode (0 = exakt)
+static bool timing_for_div(uint32_t sys_hz, uint32_t freq_hz, uint32_t min_steps, bool phase_correct, uint32_t div16,
+                           pwm_timing_t *t, uint64_t *err)
+{
+    uint64_t ideal = (uint64_t)sys_hz * 16u;                      // 16 * sys_hz
+    uint64_t div_k = (uint64_t)div16 * (phase_correct ? 2u : 1u); // Sechzehntel-Takte je Zählschritt
+    uint64_t per_step = div_k * freq_hz;
+    uint64_t steps = (ideal + per_step / 2u) / per_step; // top + 1, gerundet
+    if (steps < min_steps || steps < 2u || steps > STEPS_MAX)
+        return false;
+
+    uint64_t actual = steps * per_step;
+    *err = actual > ideal ? actual - ideal : ideal - actual;
+    t->top = (uint16_t)(steps - 1u);
+    t->div_int = (uint8_t)(div16 >> 4);
+    t->div_frac = (uint8_t)(div16 & 15u);
+    t->phase_correct = phase_correct;
+    t->freq_mhz = (uint32_t)(ideal * 1000u / (steps * div_k));
+    return true;
+}
+
+bool pwm_timing_calc(uint32_t sys_hz, uint32_t freq_hz, uint32_t min_steps, bool phase_correct, pwm_timing_t *out)
+{
+    if (freq_hz == 0)
+        return false;
+
+    bool found = false;
+    uint64_t best_err = 0;
+    for (uint32_t div16 = DIV16_MIN; div16 <= DIV16_MAX; ++div16)
+    {
+        pwm_timing_t t;
+        uint64_t err;
+        if (!timing_for_div(sys_hz, freq_hz, min_steps, phase_correct, div16, &t, &err))
+        {
+            if (found)
+                break; // größere Teiler -> noch weniger Stufen
+            continue;  // Teiler noch zu klein (TOP würde überlaufen)
+        }
+        if (!found || err < best_err)
+        {
+            *out = t;
+            best_err = err;
+            found = true;
+        }
+        if (err == 0)
+            break; // kleinster Teiler mit exakter Frequenz
+    }
+    return found;
+}
+
+// Wrap-Interrupt, nur nach einem Teilerwechsel freigegeben: TOP/CC sind gerade übernommen
+static void pwm_engine_isr(void)
+{
+    if (!div_pending || !hal_pwm_wrap_pending(wrap_slice))
+        return; // gemeinsamer PWM-Interrupt gilt einem anderen Slice
+    hal_pwm_wrap_irq_set_enabled(wrap_slice, false);
+    div_pending = false;
+    for (uint s = 0; s < PWM_SLICES; ++s)
+        if (slices & (1u << s))
+            hal_pwm_set_clkdiv_int_frac(s, timing.div_int, timing.div_frac);
+}
+
+void pwm_engine_init(uint32_t slice_mask, uint wrap, const pwm_timing_t *t)
+{
+    timing = *t;
+    slices = slice_mask;
+    wrap_slice = wrap;
+    for (uint s = 0; s < PWM_SLICES; ++s)
+    {
+        if (!(slice_mask & (1u << s)))
+            continue;
+        hal_pwm_set_phase_correct(s, t->phase_correct);
+        hal_pwm_set_clkdiv_int_frac(s, t->div_int, t->div_frac);
+        hal_pwm_set_wrap(s, t->top);
+        for (uint c = 0; c < 2; ++c)
+        {
+            level[s][c] = 0;
+            hal_pwm_set_chan_level(s, c, 0u); // Kanal-Level initial 0 (kein PWM)
+        }
+        hal_pwm_set_counter(s, 0);
+    }
+    hal_pwm_set_mask_enabled(slice_mask); // alle Slices im selben Takt starten (phasensynchron)
+    hal_pwm_wrap_irq_init(wrap_slice, pwm_engine_isr, COMM_IRQ_PRIORITY, PWM_ENGINE_IRQ_ORDER);
+}
+
+void pwm_engine_set_level(uint slice, uint chan, uint16_t lvl)
+{
+    level[slice][chan] = lvl;
+    hal_pwm_set_chan_level(slice, chan, to_counts(lvl));
+}
+
+bool pwm_engine_set_freq(uint32_t freq_hz, uint32_t min_steps)
+{
+    uint32_t sys_hz = hal_clock_sys_hz();
+    uint32_t div16 = ((uint32_t)timing.div_int << 4) | timing.div_frac;
+    pwm_timing_t t;
+    uint64_t err;
+
+    // bevorzugt mit dem bisherigen Teiler (nur TOP ändern), wenn das genauso exakt ist
+    bool same_div = timing_for_div(sys_hz, freq_hz, min_steps, timing.phase_correct, div16, &t, &err) && err == 0;
+    if (!same_div)
+    {
+        if (!pwm_timing_calc(sys_hz, freq_hz, min_steps, timing.phase_correct, &t))
+            return false;
+        same_div = t.div_int == timing.div_int && t.div_frac == timing.div_frac;
+    }
+
+    uint32_t irq = hal_irq_save(); // kein set_level mit altem TOP dazwischen (nur Registerzugriffe)
+    if (!same_div)
+        hal_pwm_wrap_clear(wrap_slice); // vor TOP: der nächste gemeldete Wrap übernimmt das neue TOP
+    timing = t;
+    for (uint s = 0; s < PWM_SLICES; ++s)
+    {
+        if (!(slices & (1u << s)))
+            continue;
+        hal_pwm_set_wrap(s, t.top); // gepuffert, gilt ab dem nächsten Wrap
+        for (uint c = 0; c < 2; ++c)
+            hal_pwm_set_chan_level(s, c, to_counts(level[s][c]));
+    }
+    if (!same_div)
+    {
+        div_pending = true;
+        hal_pwm_wrap_irq_set_enabled(wrap_slice, true); // Teiler setzt pwm_engine_isr am Wrap
+    }
+    hal_irq_restore(irq);
+    return true;
+}
+
+const pwm_timing_t *pwm_engine_timing(void)
+{
+    return &timing;
+}
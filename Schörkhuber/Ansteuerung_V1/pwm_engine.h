@@ -0,0 +1,53 @@
+// pwm_engine.h
+// PWM-Erzeugung der Low-Sides: Teiler und Zählumfang (TOP) werden ganzzahlig so bestimmt,
+// dass die gewünschte Frequenz exakt (bzw. so genau wie möglich) und mit mindestens der
+// geforderten Auflösung erreicht wird. Bisher wurde mit PWM_WRAP = 65535 ein float-Teiler
+// < 1 berechnet und auf 1 begrenzt -> nur 1,9 kHz statt 20 kHz.
+//
+// Alle Slices laufen mit demselben Timing, starten gemeinsam (pwm_set_mask_enabled) und bleiben
+// phasengleich. Im mittenzentrierten Betrieb (phase-correct) zählt der Zähler 0 -> TOP -> 0;
+// die Einschaltzeit liegt symmetrisch um den Zählerstand 0. Dort meldet der Slice seinen Wrap
+// (Interrupt, DMA-Anforderung): die Mitte des LS-Einschaltpulses, an der current.c den Strom im
+// Shunt misst. Der Zählerstand TOP ist die Mitte der Ausschaltzeit.
+//
+// Duty-Werte bleiben im ganzen Programm auf der Skala 0..PWM_WRAP (= 0..100 %) und werden erst
+// hier auf den Zählumfang umgerechnet. Die Frequenz kann im Betrieb geändert werden: TOP und
+// CC-Werte sind in der Hardware gepuffert und gelten ab dem nächsten Wrap, den Teiler schreibt
+// der Wrap-Interrupt dieses Moduls direkt nach diesem Wrap.
+
+#ifndef PWM_ENGINE_H
+#define PWM_ENGINE_H
+
+#include "hal.h"
+
+typedef struct
+{
+    uint16_t top;       // Zählumfang - 1 (Register TOP), Auflösung = top + 1 Stufen
+    uint8_t div_int;    // Taktteiler 1..255
+    uint8_t div_frac;   // Taktteiler, Sechzehntel 0..15
+    bool phase_correct; // mittenzentriert (Periode = 2 * (top + 1) Zählschritte)
+    uint32_t freq_mhz;  // tatsächliche PWM-Frequenz in mHz
+} pwm_timing_t;
+
+// Timing für freq_hz mit mindestens min_steps Duty-Stufen berechnen. Unter allen Teilern, mit
+// denen die Frequenz exakt erreicht wird, gewinnt der kleinste (= größte Auflösung); geht es
+// nicht exakt, der mit dem kleinsten Frequenzfehler. false, wenn min_steps nicht erreichbar ist.
+bool pwm_timing_calc(uint32_t sys_hz, uint32_t freq_hz, uint32_t min_steps, bool phase_correct, pwm_timing_t *out);
+
+// Slices aus slice_mask einrichten (alle Kanäle 0 %), Zähler auf 0, gemeinsam starten.
+// wrap_slice (aus slice_mask, von keinem anderen Wrap-Handler benutzt) meldet den Wrap für
+// Teilerwechsel; der Interrupt wird auf dem aufrufenden Kern registriert (core1).
+void pwm_engine_init(uint32_t slice_mask, uint wrap_slice, const pwm_timing_t *t);
+
+// Duty 0..PWM_WRAP eines Kanals setzen (gilt ab dem nächsten Wrap)
+void pwm_engine_set_level(uint slice, uint chan, uint16_t level);
+
+// Frequenz im Betrieb ändern (Auflösung mindestens min_steps). Kehrt sofort zurück; ein neuer
+// Teiler wird am nächsten Wrap im Interrupt gesetzt. Aufruf auf core1, nicht aus Interrupts.
+// false = nicht erreichbar, nichts geändert.
+bool pwm_engine_set_freq(uint32_t freq_hz, uint32_t min_steps);
+
+// aktuelles Timing
+const pwm_timing_t *pwm_engine_timing(void);
+
+#endif // PWM_ENGINE_H
@@ -0,0 +1,80 @@
+// ramp.c
+// Open-Loop-Rampe, siehe ramp.h. Aufruf aus dem Kommutations-Interrupt (je Schritt einmal);
+// Division und Wurzel (64 bit) kosten auf dem M0+ einige µs, bei mind. STEP_TIME_MIN_US je Schritt vertretbar.
+
+#include "ramp.h"
+#include "config.h"
+
+#define RAMP_US_Q8 256000000u                 // 1 s in µs, Q8: Schrittdauer = RAMP_US_Q8 / rate_q8
+#define RAMP_ACCEL_MIN (RAMP_ACCEL / 8u + 1u) // S-Kurve: Rest-Beschleunigung, damit das Ziel sicher erreicht wird
+
+static uint32_t rate_of(uint32_t step_us)
+{
+    return RAMP_US_Q8 / step_us; // STEP_TIME_MIN_US..STEP_TIME_MAX_US -> 128..512000
+}
+
+// Ganzzahl-Wurzel (abgerundet), bitweise ohne Multiplikation
+static uint32_t isqrt64(uint64_t x)
+{
+    uint64_t r = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > x)
+        bit >>= 2;
+    while (bit)
+    {
+        if (x >= r + bit)
+        {
+            x -= r + bit;
+            r = (r >> 1) + bit;
+        }
+        else
+            r >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+void ramp_reset(ramp_t *r, uint32_t step_us)
+{
+    r->rate_q8 = rate_of(step_us);
+    r->accel = RAMP_JERK ? RAMP_ACCEL_MIN : RAMP_ACCEL;
+}
+
+uint32_t ramp_next(ramp_t *r, uint32_t target_us)
+{
+    uint32_t rate = r->rate_q8;
+    uint32_t target = rate_of(target_us);
+    if (rate == target)
+        return target_us; // am Ziel: genau die vorgegebene Schrittdauer (ohne Rundung der Rate)
+    uint32_t dt = RAMP_US_Q8 / rate; // dieser Schritt läuft noch mit der aktuellen Rate
+
+#if RAMP_JERK
+    // S-Kurve: a steigt je Schritt um j * dt; sobald der Rest der Rate nur noch für den Abbau
+    // reicht (a^2 / 2j), sinkt a wieder
+    uint32_t gap = rate < target ? target - rate : rate - target;
+    uint32_t da = (uint32_t)((uint64_t)RAMP_JERK * dt / 1000000u);
+    if ((uint64_t)r->accel * r->accel * 256u / (2u * RAMP_JERK) >= gap)
+        r->accel = r->accel > RAMP_ACCEL_MIN + da ? r->accel - da : RAMP_ACCEL_MIN;
+    else
+        r->accel = r->accel + da < RAMP_ACCEL ? r->accel + da : RAMP_ACCEL;
+#endif
+
+    // v^2 ändert sich je Schritt um 2a (in Q16, da v in Q8)
+    uint64_t v2 = (uint64_t)rate * rate;
+    uint64_t dv2 = (uint64_t)r->accel * (2u << 16);
+    if (rate < target)
+    {
+        uint32_t v = isqrt64(v2 + dv2);
+        r->rate_q8 = v < target ? v : target;
+    }
+    else
+        r->rate_q8 = v2 > (uint64_t)target * target + dv2 ? isqrt64(v2 - dv2) : target;
+    if (r->rate_q8 == target)
+        r->accel = RAMP_JERK ? RAMP_ACCEL_MIN : RAMP_ACCEL; // nächste Rampe beginnt wieder sanft
+    return dt;
+}
+
+bool ramp_running(const ramp_t *r, uint32_t target_us)
+{
+    return r->rate_q8 != rate_of(target_us);
+}
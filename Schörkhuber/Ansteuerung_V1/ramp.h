@@ -0,0 +1,33 @@
+// ramp.h
+// Beschleunigungsrampe für den Open-Loop: statt die Schrittdauer in Sprüngen zu ändern (der
+// Rotor kommt dann nicht mit und fällt außer Tritt), liefert ramp_next() Schritt für Schritt
+// die nächste Schrittdauer auf dem Weg zur Ziel-Schrittdauer.
+//
+// Gerechnet wird in der Schrittrate v (Schritte/s, Q24.8), nur mit Ganzzahlen: je Schritt gilt
+// v_neu^2 = v^2 +- 2a (gleichmäßige Beschleunigung über genau einen Schritt). Mit fester Beschleunigung
+// (RAMP_JERK = 0) ergibt das die bekannte Folge dt_n ~ sqrt(n + 1) - sqrt(n), auch bei langen ersten
+// Schritten ohne Überschwingen; mit RAMP_JERK > 0 steigt a mit dem Ruck auf RAMP_ACCEL an und wird
+// vor dem Ziel wieder abgebaut (S-Kurve). Eine Division und eine Ganzzahl-Wurzel je Schritt, keine Tabelle.
+
+#ifndef RAMP_H
+#define RAMP_H
+
+#include "hal.h"
+
+typedef struct
+{
+    uint32_t rate_q8; // aktuelle Schrittrate (Schritte/s, Q24.8)
+    uint32_t accel;   // aktuelle Beschleunigung (Schritte/s²)
+} ramp_t;
+
+// Rampe bei step_us beginnen lassen (Stillstand: Startschrittdauer, fliegend: aktuelle)
+void ramp_reset(ramp_t *r, uint32_t step_us);
+
+// Dauer des nächsten Schritts (µs) und Rate für den Schritt danach Richtung target_us nachführen.
+// target_us darf sich jederzeit ändern (STEP_TIME_MIN_US..STEP_TIME_MAX_US).
+uint32_t ramp_next(ramp_t *r, uint32_t target_us);
+
+// true, solange die Rampe das Ziel noch nicht erreicht hat
+bool ramp_running(const ramp_t *r, uint32_t target_us);
+
+#endif // RAMP_H
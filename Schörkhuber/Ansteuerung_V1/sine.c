@@ -0,0 +1,143 @@
+// sine.c
+// Sinus-Kommutation im PWM-Wrap-Interrupt, siehe sine.h.
+//
+// Winkel: 32 bit = 360° el., die oberen 8 bit indizieren die Tabelle (1,4° Auflösung).
+// Je Periode: Winkel += angle_step, drei Tabellenwerte (0°, -120°, -240°), obere Phase suchen,
+// Duty der anderen = (u_oben - u_x) * scale. Der Schaltzustand (welcher HS ein ist) wechselt
+// alle 120° el.; das macht bldc_sine_apply über zwei PWM-Perioden mit Totzeit dazwischen.
+
+#include "sine.h"
+#include "bldc.h"
+#include "config.h"
+#include "pwm_engine.h"
+#include "telemetry.h"
+
+#define ANGLE_DEG(d) ((uint32_t)(((uint64_t)(d) << 32) / 360u)) // Grad el. -> Winkel (2^32 = 360°)
+#define ANGLE_120 0x55555555u
+// größte Differenz zweier Phasen (verkettete Spannung): sqrt(3) in Q15
+#define SINE_LL_MAX_Q15 56755u
+
+// sin(2*pi*i/256) in Q15
+static const int16_t SINE_Q15[256] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739,
+    9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594, 23170, 23731, 24279, 24811,
+    25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521,
+    32609, 32678, 32728, 32757, 32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285,
+    32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571, 30273, 29956, 29621, 29268,
+    28898, 28510, 28105, 27683, 27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+    23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868, 18204, 17530, 16846, 16151,
+    15446, 14732, 14010, 13279, 12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179,
+    6393, 5602, 4808, 4011, 3212, 2410, 1608, 804, 0, -804, -1608, -2410,
+    -3212, -4011, -4808, -5602, -6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159,
+    -20787, -21403, -22005, -22594, -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+    -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956, -30273, -30571, -30852, -31113,
+    -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580,
+    -31356, -31113, -30852, -30571, -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+    -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731, -23170, -22594, -22005, -21403,
+    -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179, -6393, -5602, -4808, -4011,
+    -3212, -2410, -1608, -804,
+};
+
+static uint wrap_slice;              // Slice, dessen Wrap den Interrupt auslöst
+static volatile bool sine_running;   // Interrupt schaltet die Brücke
+static uint32_t angle;               // el. Winkel (nur Interrupt, außer beim Start)
+static volatile uint32_t angle_step; // Winkel je PWM-Periode
+static volatile uint32_t advance = ANGLE_DEG(SINE_ADVANCE_DEG);
+static volatile uint32_t advance_deg = SINE_ADVANCE_DEG;
+static volatile uint32_t scale_q15; // Duty je Q15-Einheit Spannungsdifferenz
+static volatile uint16_t sine_level;
+static uint8_t last_sector; // für die Telemetrie (ein Messpunkt je 60° el.)
+
+#if !BLDC_DEADTIME_PIO
+static void sine_isr(void)
+{
+    if (!hal_pwm_wrap_pending(wrap_slice))
+        return; // gemeinsamer PWM-Interrupt gilt einem anderen Slice
+    hal_pwm_wrap_clear(wrap_slice);
+    if (!sine_running)
+        return;
+
+    angle += angle_step;
+    uint32_t a = angle + advance;
+    int32_t u[3] = {SINE_Q15[a >> 24], SINE_Q15[(a - ANGLE_120) >> 24], SINE_Q15[(a - 2u * ANGLE_120) >> 24]};
+
+    // höchste Phase an die Versorgung, die anderen per LS-PWM um die Differenz darunter
+    uint8_t top = u[0] >= u[1] ? (u[0] >= u[2] ? 0 : 2) : (u[1] >= u[2] ? 1 : 2);
+    uint32_t k = scale_q15;
+    uint16_t level[3];
+    for (int i = 0; i < 3; ++i)
+        level[i] = (uint16_t)(((uint32_t)(u[top] - u[i]) * k) >> 15);
+    bldc_sine_apply(MAIN_MOTOR, top, level);
+
+    // 6-Step-Schritt s entspricht 30° + s * 60° .. 90° + s * 60°
+    uint8_t sector = (uint8_t)((((a - ANGLE_DEG(30)) >> 24) * 6u) >> 8);
+    if (sector != last_sector)
+    {
+        last_sector = sector;
+        telemetry_record(hal_time_us_32(), sector, sine_level, TELEM_FLAG_SINE);
+    }
+}
+#endif
+
+void sine_init(void)
+{
+#if !BLDC_DEADTIME_PIO
+    wrap_slice = MAIN_MOTOR->ls_slice[1]; // Slice von Phase A gehört der Strommessung
+    hal_pwm_wrap_irq_init(wrap_slice, sine_isr, COMM_IRQ_PRIORITY, SINE_IRQ_ORDER);
+#endif
+}
+
+bool sine_start(uint16_t pwm_level, int step)
+{
+#if BLDC_DEADTIME_PIO
+    (void)pwm_level;
+    (void)step;
+    return false;
+#else
+    sine_set_level(pwm_level);
+    angle = ANGLE_DEG(60u * (uint32_t)(step + 1)); // Mitte des Schritts: HS-Phase oben, LS-Phase unten
+    last_sector = 0xff;
+    sine_running = true;
+    hal_pwm_wrap_irq_set_enabled(wrap_slice, true);
+    return true;
+#endif
+}
+
+void sine_stop(void)
+{
+#if !BLDC_DEADTIME_PIO
+    hal_pwm_wrap_irq_set_enabled(wrap_slice, false);
+#endif
+    sine_running = false;
+}
+
+void sine_set_level(uint16_t pwm_level)
+{
+    sine_level = pwm_level;
+    scale_q15 = (uint32_t)pwm_level * 32768u / SINE_LL_MAX_Q15; // Produkt im Interrupt bleibt < 2^31
+}
+
+void sine_set_step_time(uint32_t step_us)
+{
+    // Winkel je Periode = 2^32 * T_pwm / (6 * step_us), T_pwm = 1e9 / freq_mhz µs
+    uint64_t den = (uint64_t)pwm_engine_timing()->freq_mhz * 6u * step_us;
+    angle_step = den ? (uint32_t)(((uint64_t)1000000000u << 32) / den) : 0;
+}
+
+void sine_set_advance(uint32_t deg)
+{
+    if (deg > SINE_ADVANCE_MAX_DEG)
+        deg = SINE_ADVANCE_MAX_DEG;
+    advance_deg = deg;
+    advance = ANGLE_DEG(deg);
+}
+
+uint32_t sine_advance(void)
+{
+    return advance_deg;
+}
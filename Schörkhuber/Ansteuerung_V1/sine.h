@@ -0,0 +1,43 @@
+// sine.h
+// Sinus-Kommutation als Alternative zum 6-Step: die drei Phasenspannungen folgen einer Q15-
+// Sinustabelle, die in jeder PWM-Periode (Wrap-Interrupt) mit einem 32-bit Winkelakkumulator
+// weitergeschaltet wird. Keine Gleitkommarechnung, im Interrupt nur Tabellenzugriffe,
+// Vergleiche und Multiplikationen.
+//
+// Die Brücke hat HS-P-MOSFETs, die nur ein/aus geschaltet werden (SIO-Richtung, externe Pull-Ups),
+// PWM gibt es nur auf den Low-Sides. Daher diskontinuierliche PWM: die Phase mit der höchsten
+// Sollspannung liegt fest an der Versorgung (HS ein), die beiden anderen bekommen per LS-PWM die
+// Differenz zu ihr. Das ist eine Gleichtaktverschiebung wie die Oberwelleneinspeisung: die
+// verketteten Spannungen bleiben sinusförmig, nutzbar bis zur vollen Versorgungsspannung.
+//
+// Die Drehzahl kommt aus step_time_us (wie im Open-Loop, sechs Schritte je el. Umdrehung).
+// Nicht im PIO-Betrieb (BLDC_DEADTIME_PIO): dort gehören die Pins der PIO.
+
+#ifndef SINE_H
+#define SINE_H
+
+#include "hal.h"
+
+// Wrap-Interrupt registrieren (noch aus); core1, nach bldc_init
+void sine_init(void);
+
+// Sinus-Betrieb starten. step = zuletzt geschalteter 6-Step-Schritt, der Winkel beginnt in
+// dessen Mitte (stoßfreie Übernahme). Ausgänge müssen aus sein (all_off).
+// false im PIO-Betrieb (nicht verfügbar).
+bool sine_start(uint16_t pwm_level, int step);
+
+// Interrupt abschalten; Ausgänge schaltet der Aufrufer ab
+void sine_stop(void);
+
+// Amplitude: PWM_WRAP = volle verkettete Spannung
+void sine_set_level(uint16_t pwm_level);
+
+// Drehzahl aus der Schrittdauer (60° el.) und der aktuellen PWM-Frequenz; nach einem
+// Frequenzwechsel erneut aufrufen
+void sine_set_step_time(uint32_t step_us);
+
+// Voreilwinkel in Grad el. (0..SINE_ADVANCE_MAX_DEG)
+void sine_set_advance(uint32_t deg);
+uint32_t sine_advance(void);
+
+#endif // SINE_H
@@ -0,0 +1,120 @@
+// speed_ctrl.c
+// PI-Drehzahlregler, Festkomma Q16.16, fester Regeltakt aus Hardware-Alarm SPEED_ALARM_NUM.
+// Ziel: Drehzahl unter Last halten und dabei nur so viel Duty geben wie nötig
+// (statt fest 80 %), das spart Strom und Erwärmung.
+//
+// Stellgröße: u = Kp*e + I, I += Ki*e (e = Soll - Ist in U/min).
+// Die Multiplikationen laufen in 64 bit (Cortex-M0+: Bibliotheksroutine, wenige µs bei 1 kHz).
+
+#include "speed_ctrl.h"
+#include "config.h"
+
+static speed_pi_t pi = {
+    .kp_q16 = SPEED_KP_Q16,
+    .ki_q16 = SPEED_KI_Q16,
+    .i_q16 = 0,
+    .out_min = SPEED_DUTY_MIN,
+    .out_max = SPEED_DUTY_MAX,
+};
+
+static uint32_t (*measure)(void); // Istdrehzahl-Quelle (Hall oder Gegen-EMK)
+static void (*apply)(uint16_t);   // Duty-Ausgabe
+static void (*tick)(uint32_t);    // Takt-Hook vor dem Regelschritt (zeitgesteuerte Sollwerte)
+
+static volatile bool ctrl_enabled = false;
+static volatile uint32_t target_rpm = SPEED_TARGET_INIT_RPM;
+static volatile uint16_t ctrl_level;
+static uint32_t ctrl_deadline; // nächster Regeltakt (timerawl)
+
+uint16_t speed_pi_update(speed_pi_t *p, int32_t target, int32_t actual)
+{
+    int32_t e = target - actual;
+    int64_t p_q16 = (int64_t)p->kp_q16 * e;
+    int64_t out_q16 = p_q16 + p->i_q16;
+    int64_t min_q16 = (int64_t)p->out_min << 16;
+    int64_t max_q16 = (int64_t)p->out_max << 16;
+
+    // Anti-Windup (bedingte Integration): nur integrieren, wenn der Ausgang nicht in der
+    // Begrenzung steht oder der Fehler aus ihr herausführt
+    if (!(out_q16 >= max_q16 && e > 0) && !(out_q16 <= min_q16 && e < 0))
+    {
+        p->i_q16 += (int64_t)p->ki_q16 * e;
+        if (p->i_q16 > max_q16)
+            p->i_q16 = max_q16;
+        else if (p->i_q16 < min_q16)
+            p->i_q16 = min_q16;
+        out_q16 = p_q16 + p->i_q16;
+    }
+
+    // Ausgangsbegrenzung
+    if (out_q16 > max_q16)
+        out_q16 = max_q16;
+    else if (out_q16 < min_q16)
+        out_q16 = min_q16;
+    return (uint16_t)(out_q16 >> 16);
+}
+
+// Regeltakt: Folgetermin absolut weiterzählen (wie comm_sched.c), dann regeln
+static void speed_ctrl_isr(void)
+{
+    hal_alarm_ack(SPEED_ALARM_NUM);
+
+    ctrl_deadline += SPEED_CTRL_PERIOD_US;
+    uint32_t now = hal_time_us_32();
+    if ((int32_t)(ctrl_deadline - now) < (int32_t)COMM_MIN_LEAD_US)
+        ctrl_deadline = now + SPEED_CTRL_PERIOD_US; // zu lange blockiert -> neu aufsetzen
+    hal_alarm_arm(SPEED_ALARM_NUM, ctrl_deadline);
+
+    if (tick)
+        tick(now); // läuft auch ohne Regelung (Open-Loop-Sollwerte)
+    if (!ctrl_enabled)
+        return;
+
+    uint16_t level = speed_pi_update(&pi, (int32_t)target_rpm, (int32_t)measure());
+    ctrl_level = level;
+    apply(level);
+}
+
+void speed_ctrl_init(uint32_t (*measure_rpm)(void), void (*apply_level)(uint16_t), void (*tick_hook)(uint32_t))
+{
+    measure = measure_rpm;
+    apply = apply_level;
+    tick = tick_hook;
+    hal_alarm_init(SPEED_ALARM_NUM, speed_ctrl_isr, SPEED_IRQ_PRIORITY);
+    ctrl_deadline = hal_time_us_32() + SPEED_CTRL_PERIOD_US;
+    hal_alarm_arm(SPEED_ALARM_NUM, ctrl_deadline);
+}
+
+void speed_ctrl_enable(uint16_t current_level)
+{
+    hal_alarm_irq_set_enabled(SPEED_ALARM_NUM, false);
+    pi.i_q16 = (int64_t)current_level << 16; // stoßfrei: Regler startet beim bisherigen Duty
+    ctrl_level = current_level;
+    ctrl_enabled = true;
+    hal_alarm_irq_set_enabled(SPEED_ALARM_NUM, true);
+}
+
+void speed_ctrl_disable(void)
+{
+    ctrl_enabled = false;
+}
+
+bool speed_ctrl_enabled(void)
+{
+    return ctrl_enabled;
+}
+
+void speed_ctrl_set_target(uint32_t rpm)
+{
+    target_rpm = rpm;
+}
+
+uint32_t speed_ctrl_target(void)
+{
+    return target_rpm;
+}
+
+uint16_t speed_ctrl_level(void)
+{
+    return ctrl_level;
+}
@@ -0,0 +1,44 @@
+// speed_ctrl.h
+// Drehzahlregler (PI) in Festkomma: der RP2040 hat keine FPU, deshalb rechnet der Regler
+// nur mit Ganzzahlen (Verstärkungen in Q16.16). Er läuft in einem eigenen Alarm-Interrupt
+// mit festem Takt (SPEED_CTRL_PERIOD_US), liest die Istdrehzahl und stellt den Duty.
+
+#ifndef SPEED_CTRL_H
+#define SPEED_CTRL_H
+
+#include "hal.h"
+
+// Zustand eines PI-Reglers
+typedef struct
+{
+    int32_t kp_q16;  // Proportionalverstärkung (Duty-Counts pro U/min, Q16.16)
+    int32_t ki_q16;  // Integralverstärkung (Duty-Counts pro U/min und Takt, Q16.16)
+    int64_t i_q16;   // Integralanteil (Duty-Counts, Q16.16)
+    int32_t out_min; // Stellgrößenbegrenzung (Duty-Counts)
+    int32_t out_max;
+} speed_pi_t;
+
+// Einen Regelschritt rechnen: liefert den neuen Duty (out_min..out_max).
+// Anti-Windup: der Integralanteil wird eingefroren, solange der Ausgang in der Begrenzung
+// steht und der Fehler weiter in dieselbe Richtung drückt, und selbst auf out_min..out_max begrenzt.
+uint16_t speed_pi_update(speed_pi_t *pi, int32_t target_rpm, int32_t actual_rpm);
+
+// Alarm einrichten. measure_rpm liefert die Istdrehzahl, apply_level übernimmt den Duty,
+// tick_hook (darf 0 sein) läuft jeden Takt vor dem Regelschritt, auch bei abgeschalteter Regelung
+// (Zeitbasis für traj.c, bekommt timerawl). Alle werden im Interrupt aufgerufen und müssen kurz sein.
+void speed_ctrl_init(uint32_t (*measure_rpm)(void), void (*apply_level)(uint16_t), void (*tick_hook)(uint32_t));
+
+// Regler ein-/ausschalten. Beim Einschalten startet der Integralanteil mit dem aktuellen
+// Duty (stoßfreie Übernahme aus dem gesteuerten Betrieb).
+void speed_ctrl_enable(uint16_t current_level);
+void speed_ctrl_disable(void);
+bool speed_ctrl_enabled(void);
+
+// Solldrehzahl in U/min (jederzeit änderbar)
+void speed_ctrl_set_target(uint32_t rpm);
+uint32_t speed_ctrl_target(void);
+
+// zuletzt ausgegebener Duty
+uint16_t speed_ctrl_level(void);
+
+#endif // SPEED_CTRL_H
@@ -0,0 +1,61 @@
+// spsc.h
+// Lock-freie Ringpuffer für genau einen Erzeuger und einen Verbraucher (SPSC),
+// z. B. core0 -> core1 (Sollwerte) und core1 -> core0 (Telemetrie).
+// Kein Mutex und keine Interruptsperre: head schreibt nur der Erzeuger, tail nur der
+// Verbraucher. Beide zählen frei durch (32 bit), der Index im Puffer ist zähler & mask.
+// Die Speicherbarriere sorgt dafür, dass der Eintrag im Puffer steht, bevor head ihn freigibt.
+
+#ifndef SPSC_H
+#define SPSC_H
+
+#include "hal.h"
+
+#include <string.h>
+
+typedef struct
+{
+    volatile uint32_t head; // nächster Schreibplatz (nur Erzeuger)
+    volatile uint32_t tail; // nächster Leseplatz (nur Verbraucher)
+    uint32_t mask;          // Kapazität - 1 (Kapazität = Zweierpotenz)
+    uint32_t elem_size;     // Größe eines Eintrags in Byte
+    uint8_t *buf;           // Speicher für Kapazität * elem_size Byte
+} spsc_t;
+
+// Ring mit Speicher statisch (dateilokal) anlegen, z. B. SPSC_DEFINE(cmd_ring, ctrl_cmd_t, 16);
+#define SPSC_DEFINE(name, type, capacity)                                                  \
+    _Static_assert(((capacity) & ((capacity) - 1)) == 0, "SPSC-Kapazität muss 2^n sein"); \
+    static type name##_buf[capacity];                                                      \
+    static spsc_t name = {0, 0, (capacity) - 1, sizeof(type), (uint8_t *)name##_buf}
+
+// Eintrag anhängen (nur Erzeuger). false, wenn der Ring voll ist.
+static inline bool spsc_push(spsc_t *q, const void *item)
+{
+    uint32_t head = q->head;
+    if (head - q->tail > q->mask)
+        return false; // voll
+    memcpy(q->buf + (head & q->mask) * q->elem_size, item, q->elem_size);
+    hal_mem_barrier(); // Daten vor dem neuen head sichtbar machen
+    q->head = head + 1;
+    return true;
+}
+
+// Ältesten Eintrag holen (nur Verbraucher). false, wenn der Ring leer ist.
+static inline bool spsc_pop(spsc_t *q, void *item)
+{
+    uint32_t tail = q->tail;
+    if (tail == q->head)
+        return false;  // leer
+    hal_mem_barrier(); // head gelesen -> erst jetzt die Daten lesen
+    memcpy(item, q->buf + (tail & q->mask) * q->elem_size, q->elem_size);
+    hal_mem_barrier(); // Daten gelesen, bevor der Platz freigegeben wird
+    q->tail = tail + 1;
+    return true;
+}
+
+// Anzahl belegter Einträge (Momentaufnahme, von beiden Seiten lesbar)
+static inline uint32_t spsc_count(const spsc_t *q)
+{
+    return q->head - q->tail;
+}
+
+#endif // SPSC_H
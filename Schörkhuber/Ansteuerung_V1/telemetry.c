@@ -0,0 +1,124 @@
+// telemetry.c
+// Telemetrie-Ring (core1 -> core0) und Versand per UART-DMA, Format siehe telemetry.h.
+// Im Interrupt kostet ein Messpunkt ein paar Speicherzugriffe und ein spsc_push; kein printf,
+// keine Sperre. Ist der Ring trotz Dezimierung voll, wird der Messpunkt verworfen und gezählt.
+
+#include "telemetry.h"
+#include "bldc.h"
+#include "config.h"
+#include "current.h"
+#include "spsc.h"
+
+SPSC_DEFINE(telem_ring, telem_sample_t, TELEM_RING_SIZE); // core1 -> core0
+
+// nur core1 (Interrupt) schreibt
+static volatile uint32_t telem_recorded;
+static volatile uint32_t telem_skipped;
+static volatile uint32_t telem_dropped;
+static uint8_t decim_shift;  // log2 der Dezimierung
+static uint32_t decim_count; // Schritte seit dem letzten aufgezeichneten
+
+// nur core0 schreibt
+static uint telem_dma_chan;
+static uint8_t telem_frame[TELEM_HEADER_LEN + TELEM_FRAME_SAMPLES * TELEM_SAMPLE_LEN + TELEM_CRC_LEN]; // Sendepuffer (DMA liest)
+static uint16_t telem_seq;
+static uint32_t telem_frames;
+
+void telemetry_record(uint32_t t_us, uint8_t step, uint16_t pwm_level, uint8_t flags)
+{
+    if (++decim_count < (1u << decim_shift))
+    {
+        telem_skipped++;
+        return;
+    }
+    decim_count = 0;
+
+    // Füllstand steuert die Dezimierung (Hysterese zwischen 1/4 und 3/4)
+    uint32_t fill = spsc_count(&telem_ring);
+    if (fill > TELEM_RING_SIZE / 4 * 3 && decim_shift < TELEM_DECIM_MAX_SHIFT)
+        decim_shift++;
+    else if (fill < TELEM_RING_SIZE / 4 && decim_shift > 0)
+        decim_shift--;
+
+    if (bldc_fault_latched(MAIN_MOTOR))
+        flags |= TELEM_FLAG_FAULT;
+    telem_sample_t s = {t_us, step, (uint8_t)(flags | (decim_shift << TELEM_DECIM_SHIFT)), pwm_level, current_last(), 0};
+    if (spsc_push(&telem_ring, &s))
+        telem_recorded++;
+    else
+        telem_dropped++;
+}
+
+uint16_t telemetry_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xffff;
+    for (size_t i = 0; i < len; ++i)
+    {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (int b = 0; b < 8; ++b)
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static inline uint8_t *put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+size_t telemetry_pack(uint8_t *out, const telem_sample_t *samples, uint n, uint16_t seq, uint16_t dropped)
+{
+    uint8_t *p = out;
+    *p++ = TELEM_SYNC0;
+    *p++ = TELEM_SYNC1;
+    *p++ = (uint8_t)n;
+    p = put16(p, seq);
+    p = put16(p, dropped);
+    for (uint i = 0; i < n; ++i)
+    {
+        const telem_sample_t *s = &samples[i];
+        p = put16(p, (uint16_t)s->t_us);
+        p = put16(p, (uint16_t)(s->t_us >> 16));
+        *p++ = s->step;
+        *p++ = s->flags;
+        p = put16(p, s->pwm_level);
+        p = put16(p, s->current);
+        p = put16(p, s->voltage);
+    }
+    p = put16(p, telemetry_crc16(out + 2, (size_t)(p - out) - 2));
+    return (size_t)(p - out);
+}
+
+void telemetry_init(void)
+{
+    telem_dma_chan = hal_uart_dma_init(TELEM_UART_TX_PIN, TELEM_BAUD);
+}
+
+uint telemetry_drain(void)
+{
+    if (hal_uart_dma_busy(telem_dma_chan))
+        return 0; // voriger Rahmen wird noch gesendet, Puffer gehört dem DMA
+
+    telem_sample_t samples[TELEM_FRAME_SAMPLES];
+    uint n = 0;
+    while (n < TELEM_FRAME_SAMPLES && spsc_pop(&telem_ring, &samples[n]))
+        n++;
+    if (n == 0)
+        return 0;
+
+    size_t len = telemetry_pack(telem_frame, samples, n, telem_seq++, (uint16_t)telem_dropped);
+    hal_uart_dma_send(telem_dma_chan, telem_frame, (uint)len);
+    telem_frames++;
+    return n;
+}
+
+void telemetry_get_stats(telem_stats_t *out)
+{
+    out->recorded = telem_recorded;
+    out->skipped = telem_skipped;
+    out->dropped = telem_dropped;
+    out->frames = telem_frames;
+    out->decim = 1u << decim_shift;
+}
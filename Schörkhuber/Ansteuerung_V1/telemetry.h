@@ -0,0 +1,76 @@
+// telemetry.h
+// Schnelle Binär-Telemetrie: pro Kommutationsschritt ein Messpunkt (Zeit, Schritt, Duty,
+// Fault-Zustand, Strom, später Spannung). core1 legt die Messpunkte im Interrupt in einen
+// vorab angelegten SPSC-Ring (spsc.h), core0 packt sie zu Rahmen und schickt sie per DMA
+// über uart1 (TELEM_UART_TX_PIN, TELEM_BAUD). Die CPU kopiert nur in den Sendepuffer,
+// das Schieben in die UART erledigt der DMA-Kanal.
+//
+// Rahmen (little endian):
+//   0xA5 0x5A | Anzahl n (u8) | Rahmen-Nr. (u16) | verworfene Messpunkte (u16, frei laufend)
+//   | n * 12 Byte Messpunkt | CRC-16/CCITT-FALSE (u16, über alles nach den Sync-Bytes)
+//
+// Kommt core0 mit dem Senden nicht nach (Ring über 3/4 voll), wird nur noch jeder 2., 4., ...
+// Schritt aufgezeichnet (Dezimierung, steht in den Flags jedes Messpunkts); unter 1/4 wieder feiner.
+// host/telemetry_decode wandelt den Datenstrom in CSV um.
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "hal.h"
+
+#include <stddef.h>
+
+// Flags je Messpunkt
+#define TELEM_FLAG_FAULT 0x01u      // Fault-Latch gesetzt (Ausgänge aus)
+#define TELEM_FLAG_HALL 0x02u       // Hall-Kommutation
+#define TELEM_FLAG_SENSORLESS 0x04u // Gegen-EMK-Kommutation (sonst Open-Loop)
+#define TELEM_FLAG_SINE 0x08u       // Sinus-Betrieb (Schritt = 60°-Sektor des Spannungswinkels)
+#define TELEM_DECIM_SHIFT 4         // Bit 4..7: log2 der Dezimierung (0 = jeder Schritt)
+
+#define TELEM_SYNC0 0xa5u
+#define TELEM_SYNC1 0x5au
+#define TELEM_HEADER_LEN 7u  // Sync, Anzahl, Rahmen-Nr., verworfen
+#define TELEM_SAMPLE_LEN 12u // Messpunkt im Rahmen
+#define TELEM_CRC_LEN 2u
+
+// Ein Messpunkt (so auch im Rahmen, little endian)
+typedef struct __attribute__((packed))
+{
+    uint32_t t_us;      // Zeitstempel des Schritts (timerawl)
+    uint8_t step;       // Kommutationsschritt 0..5
+    uint8_t flags;      // TELEM_FLAG_*, Dezimierung
+    uint16_t pwm_level; // Duty 0..PWM_WRAP
+    uint16_t current;   // ADC-Rohwert Strom in der Mitte der letzten PWM-Periode (ohne CURRENT_SENSE: 0)
+    uint16_t voltage;   // ADC-Rohwert Zwischenkreisspannung (noch nicht gemessen: 0)
+} telem_sample_t;
+
+_Static_assert(sizeof(telem_sample_t) == TELEM_SAMPLE_LEN, "Messpunkt muss 12 Byte haben");
+
+typedef struct
+{
+    uint32_t recorded; // in den Ring gelegt
+    uint32_t skipped;  // wegen Dezimierung ausgelassen
+    uint32_t dropped;  // Ring voll -> verworfen
+    uint32_t frames;   // gesendete Rahmen
+    uint32_t decim;    // aktuelle Dezimierung (1 = jeder Schritt)
+} telem_stats_t;
+
+// ---- core1 (Kommutations-Interrupt) ----
+// Messpunkt aufzeichnen; flags = Betriebsart (TELEM_FLAG_HALL/SENSORLESS), Fault wird ergänzt.
+// Nur ein Erzeuger: aufrufen nur aus dem jeweils aktiven Kommutations-Interrupt.
+void telemetry_record(uint32_t t_us, uint8_t step, uint16_t pwm_level, uint8_t flags);
+
+// ---- core0 ----
+// uart1 und den Sende-DMA-Kanal einrichten
+void telemetry_init(void);
+// Ist der DMA-Kanal frei, bis TELEM_FRAME_SAMPLES Messpunkte als Rahmen verschicken.
+// Rückgabe: Anzahl verschickter Messpunkte
+uint telemetry_drain(void);
+void telemetry_get_stats(telem_stats_t *out);
+
+// Rahmen aus n Messpunkten in out packen (mind. TELEM_HEADER_LEN + n * 12 + 2 Byte), Rückgabe Länge
+size_t telemetry_pack(uint8_t *out, const telem_sample_t *samples, uint n, uint16_t seq, uint16_t dropped);
+// CRC-16/CCITT-FALSE (Polynom 0x1021, Start 0xFFFF), auch vom Host-Decoder benutzt
+uint16_t telemetry_crc16(const uint8_t *data, size_t len);
+
+#endif // TELEMETRY_H
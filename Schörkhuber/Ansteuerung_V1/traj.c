@@ -0,0 +1,113 @@
+// traj.c
+// Trajektorie aus zeitgesteuerten Sollwerten, siehe traj.h.
+// Der Takt-Interrupt ist der einzige Verbraucher des Rings: Start und Stopp aus control_poll()
+// setzen nur Anforderungen, die der nächste Takt übernimmt (kein zweiter Verbraucher, keine Sperre).
+// Der nächste Punkt wird aus dem Ring geholt und bis zu seinem Termin in next gehalten.
+// Nummern: pushed zählt core0, popped der Takt; der Ring ist FIFO, also hat der nächste Punkt im
+// Ring die Nummer popped. Der Takt übernimmt zuerst den Stopp, dann den Start: Stopp, Upload und
+// Start innerhalb eines Takts starten das neue Profil.
+
+#include "traj.h"
+#include "config.h"
+#include "spsc.h"
+
+SPSC_DEFINE(traj_ring, traj_point_t, TRAJ_POINTS); // core0 -> core1
+
+static void (*apply_point)(const traj_point_t *p);
+
+static volatile bool start_req; // Anforderungen aus control_poll(), übernimmt traj_tick()
+static volatile bool stop_req;
+static volatile uint32_t stop_before; // Punkte mit kleinerer Nummer verwirft der Stopp
+static volatile bool running;
+static volatile uint32_t pushed; // angehängte Punkte (schreibt nur core0)
+static uint32_t popped;          // aus dem Ring geholte Punkte (nur Interrupt)
+static uint32_t t0_us;           // Zeitnullpunkt (timerawl beim Start)
+static traj_point_t next;        // nächster Punkt, schon aus dem Ring geholt
+static bool have_next;           // next gültig
+static traj_stats_t stats;       // im Interrupt geschrieben
+
+void traj_init(void (*apply)(const traj_point_t *p))
+{
+    apply_point = apply;
+}
+
+void traj_tick(uint32_t now_us)
+{
+    if (stop_req)
+    {
+        // nur verwerfen, was vor dem Stopp angehängt wurde; ein neues Profil bleibt im Ring
+        uint32_t before = stop_before;
+        stop_req = false;
+        if (have_next && (int32_t)(popped - 1u - before) < 0)
+            have_next = false;
+        traj_point_t p;
+        while ((int32_t)(popped - before) < 0 && spsc_pop(&traj_ring, &p))
+            popped++;
+        running = false;
+    }
+    if (start_req)
+    {
+        t0_us = now_us;
+        running = true;
+        start_req = false;
+    }
+    if (!running)
+        return;
+
+    while (have_next || spsc_pop(&traj_ring, &next))
+    {
+        if (!have_next)
+            popped++;
+        have_next = true;
+        uint32_t due = t0_us + next.t_ms * 1000u;
+        int32_t late = (int32_t)(now_us - due);
+        if (late < 0)
+            return; // noch nicht fällig
+        if ((uint32_t)late >= SPEED_CTRL_PERIOD_US)
+            stats.late++;
+        if ((uint32_t)late > stats.max_late_us)
+            stats.max_late_us = (uint32_t)late;
+        apply_point(&next);
+        stats.done++;
+        have_next = false;
+    }
+}
+
+void traj_start(void)
+{
+    start_req = true;
+}
+
+void traj_stop(uint32_t before)
+{
+    start_req = false; // zuerst: unterbricht der Takt hier, läuft ein alter Start nicht an
+    stop_before = before;
+    stop_req = true;
+}
+
+// Zähler schreibt nur der Interrupt; eine leicht veraltete Momentaufnahme reicht für die Meldung
+void traj_get_stats(traj_stats_t *out)
+{
+    *out = stats;
+    out->queued = spsc_count(&traj_ring) + (have_next ? 1u : 0u);
+    out->running = running;
+}
+
+uint traj_push(const traj_point_t *points, uint n)
+{
+    uint i = 0;
+    while (i < n && spsc_push(&traj_ring, &points[i]))
+        ++i;
+    pushed += i; // erst nach dem Einstellen: ein Stopp mit dieser Nummer erfasst die Punkte sicher
+    return i;
+}
+
+uint traj_space(void)
+{
+    return TRAJ_POINTS - spsc_count(&traj_ring);
+}
+
+uint32_t traj_pushed(void)
+{
+    return pushed;
+}
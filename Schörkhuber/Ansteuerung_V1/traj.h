@@ -0,0 +1,64 @@
+// traj.h
+// Zeitgesteuerte Sollwerte (Trajektorie): core0 lädt eine Folge von Punkten "zum Zeitpunkt t
+// Drehzahl/Duty/Schrittdauer = x" in einen vorab angelegten SPSC-Ring (spsc.h), core1 führt sie im
+// Takt-Interrupt des Drehzahlreglers (SPEED_ALARM_NUM, Auflösung SPEED_CTRL_PERIOD_US) termingerecht
+// aus. Ein ganzes Bewegungsprofil kommt so in einem Rutsch, längere werden nachgeschoben, während
+// die ersten Punkte schon laufen; das Timing hängt nicht mehr an der Latenz der Verbindung.
+//
+// Ablauf: traj_push() (core0) füllt den Ring, CTRL_CMD_TRAJ_START setzt den Zeitnullpunkt,
+// CTRL_CMD_TRAJ_STOP verwirft den Rest. Zeitpunkte sind ms ab dem Start und dürfen nicht fallen;
+// ein Punkt, der erst nach seinem Termin ankommt (Ring leergelaufen), wird sofort ausgeführt und
+// als verspätet gezählt. Punkte sind ab 0 durchnummeriert; der Stopp trägt die Nummer des ersten
+// Punkts nach ihm (traj_pushed() beim Senden) und verwirft nur die davor. So geht ein neues
+// Profil, das nach dem Stopp, aber vor dem nächsten Takt hochgeladen wird, nicht verloren.
+// Auf core0 lädt die Konsole Punkte hoch ("TRAJ ..." in main.c).
+
+#ifndef TRAJ_H
+#define TRAJ_H
+
+#include "hal.h"
+
+typedef enum
+{
+    TRAJ_SPEED,     // value = Drehzahl in U/min (geregelt: Solldrehzahl, Open-Loop: Ziel-Schrittdauer)
+    TRAJ_DUTY,      // value = Duty 0..PWM_WRAP im gesteuerten Betrieb (geregelt: ignoriert)
+    TRAJ_STEP_TIME, // value = Ziel-Schrittdauer in µs (Open-Loop)
+} traj_kind_t;
+
+typedef struct
+{
+    uint32_t t_ms;  // Zeitpunkt ab CTRL_CMD_TRAJ_START
+    uint32_t value; // je nach kind
+    uint8_t kind;   // traj_kind_t
+} traj_point_t;
+
+typedef struct
+{
+    uint32_t done;        // ausgeführte Punkte
+    uint32_t late;        // Punkte, die mehr als einen Takt nach ihrem Termin ausgeführt wurden
+    uint32_t max_late_us; // größte Verspätung
+    uint32_t queued;      // noch im Ring
+    bool running;         // Trajektorie gestartet
+} traj_stats_t;
+
+// ---- core1 ----
+// apply führt einen fälligen Punkt aus (im Interrupt, muss kurz sein)
+void traj_init(void (*apply)(const traj_point_t *p));
+// Takt-Hook (Aufruf je Regeltakt aus dem Alarm-Interrupt): fällige Punkte ausführen
+void traj_tick(uint32_t now_us);
+// Start/Stopp (wirken im nächsten Takt, in Aufrufreihenfolge). Stopp verwirft alle noch nicht
+// ausgeführten Punkte mit einer Nummer vor before und hebt einen noch nicht übernommenen Start auf.
+void traj_start(void);
+void traj_stop(uint32_t before);
+void traj_get_stats(traj_stats_t *out);
+
+// ---- core0 ----
+// bis zu n Punkte anhängen (auch während die Trajektorie läuft); Rückgabe: übernommene Punkte,
+// weniger als n, wenn der Ring voll ist -> Rest später erneut schicken
+uint traj_push(const traj_point_t *points, uint n);
+// freie Plätze im Ring
+uint traj_space(void);
+// Anzahl bisher angehängter Punkte = Nummer des nächsten (auch von core1 lesbar)
+uint32_t traj_pushed(void);
+
+#endif // TRAJ_H